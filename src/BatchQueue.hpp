@@ -0,0 +1,181 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_FASTDDS__INTERNAL__BATCHQUEUE_HPP_
+#define _IS_SH_FASTDDS__INTERNAL__BATCHQUEUE_HPP_
+
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+/**
+ * @class BatchQueue
+ *        Bounded queue between several producers and a single consumer, which takes all the
+ *        queued items at once, so that it can process them as a batch while the producers
+ *        keep on queuing new ones.
+ *
+ *        When the queue is full, the producers are blocked until the consumer takes the items.
+ *
+ * @tparam T The type of the queued items.
+ */
+template<typename T>
+class BatchQueue
+{
+public:
+
+    /**
+     * @brief Construct a new BatchQueue object.
+     *
+     * @param[in] capacity Maximum number of items waiting in the queue.
+     */
+    explicit BatchQueue(
+            std::size_t capacity)
+        : capacity_(capacity)
+        , stop_(false)
+    {
+        items_.reserve(capacity_);
+    }
+
+    /**
+     * @brief BatchQueue shall not be copy constructible.
+     */
+    BatchQueue(
+            const BatchQueue& /*rhs*/) = delete;
+
+    /**
+     * @brief BatchQueue shall not be copy assignable.
+     */
+    BatchQueue& operator = (
+            const BatchQueue& /*rhs*/) = delete;
+
+    /**
+     * @brief BatchQueue shall not be move constructible.
+     */
+    BatchQueue(
+            BatchQueue&& /*rhs*/) = delete;
+
+    /**
+     * @brief BatchQueue shall not be move assignable.
+     */
+    BatchQueue& operator = (
+            BatchQueue&& /*rhs*/) = delete;
+
+    /**
+     * @brief Queue a new item. If the queue is full, the caller is blocked until some room is available.
+     *
+     * @param[in] item The item to queue.
+     *
+     * @returns `true` if the item was queued, or `false` if the queue is already stopped.
+     */
+    bool push(
+            T&& item)
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        not_full_cv_.wait(lock, [this]()
+                {
+                    return stop_ || items_.size() < capacity_;
+                });
+
+        if (stop_)
+        {
+            return false;
+        }
+
+        items_.emplace_back(std::move(item));
+        lock.unlock();
+        not_empty_cv_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Take all the queued items, waiting for some to be queued if there is none.
+     *
+     * @param[out] batch The taken items, replacing its previous contents. Its storage is
+     *             handed over to the queue for the next items, so none is allocated in the long run.
+     *
+     * @returns `false` if the queue is stopped and there are no items left.
+     */
+    bool pop_all(
+            std::vector<T>& batch)
+    {
+        batch.clear();
+
+        std::unique_lock<std::mutex> lock(mtx_);
+        not_empty_cv_.wait(lock, [this]()
+                {
+                    return stop_ || !items_.empty();
+                });
+
+        if (items_.empty())
+        {
+            return false;
+        }
+
+        items_.swap(batch);
+        lock.unlock();
+        not_full_cv_.notify_all();
+        return true;
+    }
+
+    /**
+     * @brief Stop accepting items, and wake up the blocked producers and consumer.
+     *        The consumer still gets the items queued so far.
+     */
+    void stop()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            stop_ = true;
+        }
+        not_full_cv_.notify_all();
+        not_empty_cv_.notify_all();
+    }
+
+    /**
+     * @brief Get the number of items waiting in the queue.
+     */
+    std::size_t size() const
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        return items_.size();
+    }
+
+private:
+
+    /**
+     * Class members.
+     */
+    const std::size_t capacity_;
+    bool stop_;
+    std::vector<T> items_;
+    mutable std::mutex mtx_;
+    std::condition_variable not_empty_cv_;
+    std::condition_variable not_full_cv_;
+};
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_FASTDDS__INTERNAL__BATCHQUEUE_HPP_
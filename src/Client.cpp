@@ -31,7 +31,9 @@
 #include <fastdds/dds/subscriber/InstanceState.hpp>
 #endif //  if FASTRTPS_VERSION_MINOR >= 2
 
+#include <algorithm>
 #include <iostream>
+#include <thread>
 
 namespace eprosima {
 namespace is {
@@ -49,14 +51,51 @@ Client::Client(
     , service_name_(service_name)
     , request_entities_(request_type)
     , reply_entities_(reply_type)
+    , received_pool_(
+        [&request_type]()
+        {
+            return new ::xtypes::DynamicData(request_type);
+        },
+        [](::xtypes::DynamicData* data)
+        {
+            delete data;
+        },
+        Conversion::is_reusable(request_type) ? std::max(1u, std::thread::hardware_concurrency()) : 0)
+    , taken_pool_(
+        [participant, service_name]()
+        {
+            return participant->create_dynamic_data(service_name + "_Request");
+        },
+        [participant](fastrtps::types::DynamicData* data)
+        {
+            participant->delete_dynamic_data(data);
+        },
+        Conversion::is_reusable(request_type) ? std::max(1u, std::thread::hardware_concurrency()) : 0)
+    , reply_pool_(
+        [participant, service_name]()
+        {
+            return participant->create_dynamic_data(service_name + "_Reply");
+        },
+        [participant](fastrtps::types::DynamicData* data)
+        {
+            participant->delete_dynamic_data(data);
+        },
+        Conversion::is_reusable(reply_type) ? std::max(1u, std::thread::hardware_concurrency()) : 0)
     , matched_mtx_()
-    , pub_sub_matched_(0)
-    , stop_cleaner_{false}
-    , cleaner_thread_{&Client::cleaner_function, this}
+    , request_matched_(false)
+    , reply_matched_(false)
+    , stopping_(false)
+    , metrics_(participant->metrics().topic("client", service_name))
     , logger_("is::sh::FastDDS::Client")
+    , reception_pool_(
+        service_name,
+        config["reception"],
+        [participant]()
+        {
+            participant->notify_event();
+        },
+        std::max(1u, std::thread::hardware_concurrency()))
 {
-    mtx_.lock(); // Lock mtx_ until datareader and datawriter have matched
-
     add_config(config, callback);
 
     // Create DynamicData
@@ -84,9 +123,6 @@ Client::Client(
                   logger_, "Cannot create builder for type " + reply_type.name());
     }
 
-    request_entities_.dynamic_data = participant->create_dynamic_data(service_name + "_Request");
-    reply_entities_.dynamic_data = participant->create_dynamic_data(service_name + "_Reply");
-
     // Retrieve DDS participant
     ::fastdds::dds::DomainParticipant* dds_participant = participant->get_dds_participant();
     if (!dds_participant)
@@ -143,6 +179,7 @@ Client::Client(
 
         // Create DDS datareader
         ::fastdds::dds::DataReaderQos datareader_qos = ::fastdds::dds::DATAREADER_QOS_DEFAULT;
+        participant_->configure_data_sharing(datareader_qos, request_entities_.dds_topic);
         ::fastdds::dds::ReliabilityQosPolicy rel_policy;
         rel_policy.kind = ::fastdds::dds::RELIABLE_RELIABILITY_QOS;
         datareader_qos.reliability(rel_policy);
@@ -219,6 +256,7 @@ Client::Client(
 
         // Create DDS datawriter
         ::fastdds::dds::DataWriterQos datawriter_qos = ::fastdds::dds::DATAWRITER_QOS_DEFAULT;
+        participant_->configure_data_sharing(datawriter_qos, reply_entities_.dds_topic);
 
         if (config["service_instance_name"])
         {
@@ -255,16 +293,16 @@ Client::~Client()
     logger_ << utils::Logger::Level::INFO
             << "Waiting for current processing messages before quitting" << std::endl;
 
-    {
-        std::unique_lock<std::mutex> lock(cleaner_mtx_);
-        stop_cleaner_ = true;
-        cleaner_cv_.notify_one();
-    }
+    request_entities_.dds_datareader->set_listener(nullptr);
 
-    if (cleaner_thread_.joinable())
+    // Release the workers waiting for the endpoints to match
     {
-        cleaner_thread_.join();
+        std::unique_lock<std::mutex> lock(matched_mtx_);
+        stopping_ = true;
     }
+    matched_cv_.notify_all();
+
+    reception_pool_.stop();
 
     logger_ << utils::Logger::Level::INFO
             << "All messages were processed. Quitting now..." << std::endl;
@@ -272,9 +310,6 @@ Client::~Client()
     ::fastdds::dds::DomainParticipant* dds_participant = participant_->get_dds_participant();
 
     {
-        std::unique_lock<std::mutex> request_lock(request_entities_.data_mtx);
-        participant_->delete_dynamic_data(request_entities_.dynamic_data);
-
         bool delete_topic = participant_->dissociate_topic_from_dds_entity(
             request_entities_.dds_topic, request_entities_.dds_datareader);
 
@@ -288,9 +323,6 @@ Client::~Client()
     }
 
     {
-        std::unique_lock<std::mutex> reply_lock(reply_entities_.data_mtx);
-        participant_->delete_dynamic_data(reply_entities_.dynamic_data);
-
         bool delete_topic = participant_->dissociate_topic_from_dds_entity(
             reply_entities_.dds_topic, reply_entities_.dds_datawriter);
 
@@ -304,23 +336,6 @@ Client::~Client()
     }
 }
 
-void Client::add_member(
-        const ::xtypes::DynamicType& type,
-        const std::string& path)
-{
-    std::shared_ptr<NavigationNode> root;
-    if (member_tree_.count(type.name()) > 0)
-    {
-        root = member_tree_[type.name()];
-    }
-    else
-    {
-        root = std::make_shared<NavigationNode>();
-        member_tree_[type.name()] = root;
-    }
-    NavigationNode::fill_root_node(root, type, path);
-}
-
 bool Client::add_config(
         const YAML::Node& config,
         ServiceClientSystem::RequestCallback* callback)
@@ -330,51 +345,45 @@ bool Client::add_config(
 
     auto add_member_config = [&](
         const YAML::Node& request_config,
-        std::string& req,
+        RequestRoute*& route,
         bool is_request) -> bool
             {
                 const std::string disc = request_config.as<std::string>();
 
-                const ::xtypes::DynamicType& member_type = Conversion::resolve_discriminator_type(
-                    is_request ? request_entities_.type : reply_entities_.type, disc);
-
-                std::string type_name;
-                if (member_type.name().find("::") == 0)
-                {
-                    type_name = member_type.name().substr(2);
-                }
-                else
+                MemberPath path;
+                if (!Conversion::compile_member_path(
+                            is_request ? request_entities_.type : reply_entities_.type, disc, path))
                 {
-                    type_name = member_type.name();
+                    logger_ << utils::Logger::Level::ERROR
+                            << "Adding config for service '" << service_name_
+                            << "': invalid member '" << disc << "'" << std::endl;
+                    return false;
                 }
 
-                type_to_discriminator_[type_name] = disc;
-                member_types_.push_back(type_name);
+                const std::string& type_name = path.type->name();
 
                 if (is_request)
                 {
-                    callbacks_[type_name] = callback;
+                    request_routes_.push_back({std::move(path), callback, MemberPath()});
                     callback_set = true;
-                    req = type_name;
+                    route = &request_routes_.back();
                 }
                 else
                 {
-                    if (req.empty())
+                    if (nullptr == route)
                     {
                         logger_ << utils::Logger::Level::ERROR
                                 << "Adding config for service '" << service_name_
                                 << "': request type cannot be empty" << std::endl;
                         return false;
                     }
-                    request_reply_[req] = type_name;
+                    route->reply_path = std::move(path);
                 }
 
                 logger_ << utils::Logger::Level::DEBUG
                         << "Member '" << disc << "' has "
                         << (is_request ? "request" : "reply") << " type '"
-                        << req << "'" << std::endl;
-
-                add_member(is_request ? request_entities_.type : reply_entities_.type, disc);
+                        << type_name << "'" << std::endl;
 
                 return true;
             };
@@ -385,19 +394,25 @@ bool Client::add_config(
         {
             if (config["remap"]["dds"]["type"])
             {
-                std::string unused;
-                add_member_config(config["remap"]["dds"]["type"], unused, true);
+                RequestRoute* route = nullptr;
+                if (!add_member_config(config["remap"]["dds"]["type"], route, true))
+                {
+                    return false;
+                }
             }
             else
             {
-                std::string req;
+                RequestRoute* route = nullptr;
                 if (config["remap"]["dds"]["request_type"])
                 {
-                    add_member_config(config["remap"]["dds"]["request_type"], req, true);
+                    if (!add_member_config(config["remap"]["dds"]["request_type"], route, true))
+                    {
+                        return false;
+                    }
                 }
                 if (config["remap"]["dds"]["reply_type"])
                 {
-                    if (!add_member_config(config["remap"]["dds"]["reply_type"], req, false))
+                    if (!add_member_config(config["remap"]["dds"]["reply_type"], route, false))
                     {
                         return false;
                     }
@@ -410,20 +425,26 @@ bool Client::add_config(
     {
         if (config["type"])
         {
-            std::string unused;
-            add_member_config(config["type"], unused, true);
+            RequestRoute* route = nullptr;
+            if (!add_member_config(config["type"], route, true))
+            {
+                return false;
+            }
         }
         else
         {
-            std::string req;
+            RequestRoute* route = nullptr;
             if (config["request_type"])
             {
-                add_member_config(config["request_type"], req, true);
+                if (!add_member_config(config["request_type"], route, true))
+                {
+                    return false;
+                }
             }
 
             if (config["reply_type"])
             {
-                if (!add_member_config(config["reply_type"], req, false))
+                if (!add_member_config(config["reply_type"], route, false))
                 {
                     return false;
                 }
@@ -438,36 +459,26 @@ void Client::receive_response(
         std::shared_ptr<void> call_handle,
         const ::xtypes::DynamicData& response)
 {
-    fastrtps::rtps::WriteParams params;
-    fastrtps::rtps::SampleIdentity sample_id =
-            *static_cast<fastrtps::rtps::SampleIdentity*>(call_handle.get());
-    params.related_sample_identity(sample_id);
+    const CallHandle& handle = *static_cast<const CallHandle*>(call_handle.get());
 
-    std::string path = reply_entities_.type.name();
-
-    {
-        std::unique_lock<std::mutex> lock(mtx_);
-        if (reply_id_type_.count(sample_id) > 0)
-        {
-            path = type_to_discriminator_[reply_id_type_[sample_id]];
-            reply_id_type_.erase(sample_id);
-        }
-    }
+    fastrtps::rtps::WriteParams params;
+    params.related_sample_identity(handle.sample_id);
 
     ::xtypes::DynamicData reply(reply_entities_.type);
 
-    Conversion::access_member_data(reply, path) = response;
+    Conversion::access_member_data(reply, handle.route->reply_path) = response;
 
     logger_ << utils::Logger::Level::INFO
             << "Translating reply from Integration Service to DDS for service reply topic '"
             << service_name_ << "_Reply': [[ " << response << " ]]" << std::endl;
 
-    std::unique_lock<std::mutex> reply_lock(reply_entities_.data_mtx);
-    bool success = Conversion::xtypes_to_fastdds(reply, reply_entities_.dynamic_data);
+    // Each reply is converted into its own data, so that replies from several threads are written at once
+    fastrtps::types::DynamicData* dds_reply = reply_pool_.acquire();
+    bool success = Conversion::xtypes_to_fastdds(reply, dds_reply);
 
     if (success)
     {
-        success = reply_entities_.dds_datawriter->write(reply_entities_.dynamic_data, params);
+        success = reply_entities_.dds_datawriter->write(dds_reply, params);
 
         if (!success)
         {
@@ -482,27 +493,29 @@ void Client::receive_response(
                 << "Failed to convert reply from Integration Service to DDS for "
                 << "service reply topic '" << service_name_ << "_Reply'" << std::endl;
     }
+
+    reply_pool_.release(dds_reply);
 }
 
 void Client::on_publication_matched(
         ::fastdds::dds::DataWriter* /*writer*/,
         const ::fastdds::dds::PublicationMatchedStatus& info)
 {
-    std::unique_lock<std::mutex> lock(matched_mtx_);
-    if (1 == info.current_count_change)
+    participant_->notify_event();
+
     {
-        pub_sub_matched_++;
-        if (2 == pub_sub_matched_)
-        {
-            mtx_.unlock();
-        }
+        std::unique_lock<std::mutex> lock(matched_mtx_);
+        reply_matched_ = 0 < info.current_count;
+    }
+    matched_cv_.notify_all();
 
+    if (1 == info.current_count_change)
+    {
         logger_ << utils::Logger::Level::INFO
                 << "Publisher for topic '" << service_name_ << "_Reply' matched" << std::endl;
     }
     else if (-1 == info.current_count_change)
     {
-        pub_sub_matched_--;
         logger_ << utils::Logger::Level::INFO
                 << "Publisher for topic '" << service_name_ << "_Reply' unmatched" << std::endl;
     }
@@ -512,21 +525,21 @@ void Client::on_subscription_matched(
         ::fastdds::dds::DataReader* /*reader*/,
         const ::fastdds::dds::SubscriptionMatchedStatus& info)
 {
-    std::unique_lock<std::mutex> lock(matched_mtx_);
-    if (1 == info.current_count_change)
+    participant_->notify_event();
+
     {
-        pub_sub_matched_++;
-        if (2 == pub_sub_matched_)
-        {
-            mtx_.unlock();
-        }
+        std::unique_lock<std::mutex> lock(matched_mtx_);
+        request_matched_ = 0 < info.current_count;
+    }
+    matched_cv_.notify_all();
 
+    if (1 == info.current_count_change)
+    {
         logger_ << utils::Logger::Level::INFO
                 << "Subscriber for topic '" << service_name_ << "_Request' matched" << std::endl;
     }
     else if (-1 == info.current_count_change)
     {
-        pub_sub_matched_--;
         logger_ << utils::Logger::Level::INFO
                 << "Subscriber for topic '" << service_name_ << "_Request' unmatched" << std::endl;
     }
@@ -535,146 +548,130 @@ void Client::on_subscription_matched(
 void Client::on_data_available(
         ::fastdds::dds::DataReader* /*reader*/)
 {
-    using namespace std::placeholders;
-
-    ::fastdds::dds::SampleInfo info;
+    // Drain the reader, handing each request over to the reception pool
+    while (true)
+    {
+        ::fastdds::dds::SampleInfo info;
+        fastrtps::types::DynamicData* request = taken_pool_.acquire();
 
-    std::unique_lock<std::mutex> lock(cleaner_mtx_);
-    request_entities_.data_mtx.lock();
+        if (fastrtps::types::ReturnCode_t::RETCODE_OK
+                != request_entities_.dds_datareader->take_next_sample(request, &info))
+        {
+            taken_pool_.release(request);
+            break;
+        }
 
-    if (!stop_cleaner_ && fastrtps::types::ReturnCode_t::RETCODE_OK
-            == request_entities_.dds_datareader->take_next_sample(request_entities_.dynamic_data, &info))
-    {
 #if FASTRTPS_VERSION_MINOR < 2
-        if (::fastdds::dds::InstanceStateKind::ALIVE == info.instance_state)
+        if (::fastdds::dds::InstanceStateKind::ALIVE != info.instance_state)
 #else
-        if (::fastdds::dds::InstanceStateKind::ALIVE_INSTANCE_STATE == info.instance_state)
+        if (::fastdds::dds::InstanceStateKind::ALIVE_INSTANCE_STATE != info.instance_state)
 #endif //  if FASTRTPS_VERSION_MINOR < 2
         {
-            logger_ << utils::Logger::Level::DEBUG
-                    << "Process incoming data available for service request topic '"
-                    << service_name_ << "_Request'" << std::endl;
-
-            std::thread* thread = new std::thread(&Client::receive, this, info.sample_identity);
-            reception_threads_.emplace(thread->get_id(), thread);
-        }
-        else
-        {
-            request_entities_.data_mtx.unlock();
+            taken_pool_.release(request);
+            continue;
         }
-    }
-    else
-    {
-        request_entities_.data_mtx.unlock();
+
+        metrics_->samples_in.fetch_add(1, std::memory_order_relaxed);
+
+        logger_ << utils::Logger::Level::DEBUG
+                << "Process incoming data available for service request topic '"
+                << service_name_ << "_Request'" << std::endl;
+
+        // The request is owned by the task from now on, or by the discard function if it is dropped
+        reception_pool_.push(
+            [this, request, sample_id = info.sample_identity]()
+            {
+                metrics_->queue_depth.store(reception_pool_.pending(), std::memory_order_relaxed);
+                receive(request, sample_id);
+            },
+            [this, request]()
+            {
+                metrics_->dropped.fetch_add(1, std::memory_order_relaxed);
+                taken_pool_.release(request);
+            });
+
+        metrics_->queue_depth.store(reception_pool_.pending(), std::memory_order_relaxed);
     }
 }
 
 void Client::receive(
+        fastrtps::types::DynamicData* request,
         fastrtps::rtps::SampleIdentity sample_id)
 {
-    {
-        ::xtypes::DynamicData received(request_entities_.type);
+    ::xtypes::DynamicData* received = received_pool_.acquire();
 
-        logger_ << utils::Logger::Level::INFO
-                << "Receiving request from DDS for service request topic '"
-                << service_name_ << "_Request'" << std::endl;
+    logger_ << utils::Logger::Level::INFO
+            << "Receiving request from DDS for service request topic '"
+            << service_name_ << "_Request'" << std::endl;
 
-        bool success = Conversion::fastdds_to_xtypes(request_entities_.dynamic_data, received);
-        request_entities_.data_mtx.unlock();
+    bool success = Conversion::fastdds_to_xtypes(request, *received);
+    taken_pool_.release(request);
 
-        if (success)
+    if (success && !wait_for_match())
+    {
+        metrics_->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    else if (success)
+    {
+        // Route the request to the first configured request type that it holds
+        const RequestRoute* route = nullptr;
+        for (const RequestRoute& candidate : request_routes_)
         {
-            std::shared_ptr<NavigationNode> member =
-                    NavigationNode::get_discriminator(member_tree_, received, member_types_);
-
+            if (Conversion::is_member_selected(*received, candidate.request_path))
             {
-                std::unique_lock<std::mutex> lock(mtx_);
-                if (request_reply_.count(member->type_name) > 0)
-                {
-                    reply_id_type_[sample_id] = request_reply_[member->type_name];
-                }
+                route = &candidate;
+                break;
             }
+        }
 
-            ::xtypes::WritableDynamicDataRef ref =
-                    Conversion::access_member_data(received, member->get_path());
+        if (nullptr != route)
+        {
+            ::xtypes::WritableDynamicDataRef ref = Conversion::access_member_data(*received, route->request_path);
             ::xtypes::DynamicData message(ref, ref.type());
 
-            if (callbacks_.count(message.type().name()))
-            {
-                (*callbacks_[message.type().name()])(
-                    message,
-                    *this, std::make_shared<fastrtps::rtps::SampleIdentity>(sample_id));
-            }
+            (*route->callback)(
+                message,
+                *this, std::make_shared<CallHandle>(CallHandle{sample_id, route}));
+
+            metrics_->samples_out.fetch_add(1, std::memory_order_relaxed);
         }
         else
         {
-            logger_ << utils::Logger::Level::ERROR
-                    << "Failed to convert message from DDS to Integration Service "
-                    << "for service request topic '" << service_name_ << "_Request'" << std::endl;
+            metrics_->dropped.fetch_add(1, std::memory_order_relaxed);
+
+            logger_ << utils::Logger::Level::WARN
+                    << "Received request of a type not configured for service '"
+                    << service_name_ << "'. Ignoring..." << std::endl;
         }
     }
-
-    // Notify that we have ended
-    std::unique_lock<std::mutex> lock(cleaner_mtx_);
-    finished_threads_.push_back(std::this_thread::get_id());
-    cleaner_cv_.notify_one();
-}
-
-void Client::cleaner_function()
-{
-    using namespace std::chrono_literals;
-    std::unique_lock<std::mutex> lock(cleaner_mtx_);
-    std::vector<std::thread::id> stopped;
-
-    while (!stop_cleaner_)
+    else
     {
-        cleaner_cv_.wait(
-            lock,
-            [this]()
-            {
-                return stop_cleaner_ || !finished_threads_.empty();
-            });
+        metrics_->dropped.fetch_add(1, std::memory_order_relaxed);
 
-        for (std::thread::id id : finished_threads_)
-        {
-            // Some threads may end too quickly, wait until the next iteration
-            if (reception_threads_.count(id) > 0)
-            {
-                std::thread* thread = reception_threads_.at(id);
-                reception_threads_.erase(id);
+        logger_ << utils::Logger::Level::ERROR
+                << "Failed to convert message from DDS to Integration Service "
+                << "for service request topic '" << service_name_ << "_Request'" << std::endl;
+    }
 
-                if (thread->joinable())
-                {
-                    thread->join();
-                }
-                delete thread;
-                stopped.push_back(id);
-            }
-        }
+    received_pool_.release(received);
+}
 
-        for (std::thread::id id : stopped)
+bool Client::wait_for_match()
+{
+    std::unique_lock<std::mutex> lock(matched_mtx_);
+    matched_cv_.wait(
+        lock,
+        [this]()
         {
-            auto it = std::find(finished_threads_.begin(), finished_threads_.end(), id);
-            finished_threads_.erase(it);
-        }
-        stopped.clear();
+            return stopping_ || (request_matched_ && reply_matched_);
+        });
 
-        // Free the CPU just a moment
-        lock.unlock();
-        std::this_thread::sleep_for(10ms);
-        lock.lock();
-    }
+    return !stopping_;
+}
 
-    // Wait for the rest of threads
-    for (auto& pair : reception_threads_)
-    {
-        std::thread* thread = pair.second;
-        if (thread->joinable())
-        {
-            thread->join();
-        }
-        delete thread;
-    }
+std::size_t Client::spin()
+{
+    return reception_pool_.spin_driven() ? reception_pool_.run_pending() : 0;
 }
 
 } //  namespace fastdds
@@ -18,8 +18,11 @@
 #ifndef _IS_SH_FASTDDS__INTERNAL__CLIENT_HPP_
 #define _IS_SH_FASTDDS__INTERNAL__CLIENT_HPP_
 
+#include "Conversion.hpp"
 #include "DDSMiddlewareException.hpp"
+#include "ObjectPool.hpp"
 #include "Participant.hpp"
+#include "WorkerPool.hpp"
 
 #include <is/systemhandle/SystemHandle.hpp>
 #include <is/utils/Log.hpp>
@@ -27,9 +30,8 @@
 #include <fastdds/dds/publisher/Publisher.hpp>
 #include <fastdds/dds/subscriber/Subscriber.hpp>
 
-#include <map>
-#include <thread>
 #include <condition_variable>
+#include <deque>
 
 namespace fastdds = eprosima::fastdds;
 
@@ -41,7 +43,6 @@ namespace fastdds {
 /**
  * @brief Forward declarations.
  */
-struct NavigationNode;
 class Participant;
 
 /**
@@ -94,6 +95,10 @@ public:
      * @param[in] callback Callback that gets triggered when a client has made a request.
      *
      * @param[in] config Additional configuration that might be required to configure this Client.
+     *            Allowed fields are:
+     *            - `reception`: Configuration of the WorkerPool in charge of processing the incoming requests.
+     *              It has one thread per core by default, as requests are independent from each other.
+     *              Without worker threads, they are processed by spin().
      */
     Client(
             eprosima::is::sh::fastdds::Participant* participant,
@@ -154,6 +159,14 @@ public:
             const YAML::Node& configuration,
             ServiceClientSystem::RequestCallback* callback);
 
+    /**
+     * @brief Process, in the calling thread, the requests waiting in the reception queue.
+     *        Only spin-driven clients, configured with `reception: { threads: 0 }`, are affected.
+     *
+     * @returns The number of processed requests.
+     */
+    std::size_t spin();
+
 private:
 
     /**
@@ -179,28 +192,21 @@ private:
     /**
      * @brief Receive a DDS service request, for the provided SampleIdentity.
      *
+     * @param[in] request The request taken from the datareader, which is released afterwards.
+     *
      * @param[in] sample_id The sample identity that identifies the incoming request.
      */
     void receive(
+            fastrtps::types::DynamicData* request,
             eprosima::fastrtps::rtps::SampleIdentity sample_id);
 
     /**
-     * @brief Add a type member to the members map.
-     *
-     * @param[in] type The type of the member.
+     * @brief Wait until both the request datareader and the reply datawriter are matched,
+     *        so that the reply to a request is not lost.
      *
-     * @param[in] path Path where the member to add is located, navigating through type nodes
-     *            by means of the `.` operator.
-     */
-    void add_member(
-            const xtypes::DynamicType& type,
-            const std::string& path);
-
-    /**
-     * @brief Function to look for threads that have already finished and delete them from the
-     *        reception threads database.
+     * @returns `false` if the Client is being destroyed.
      */
-    void cleaner_function();
+    bool wait_for_match();
 
     /**
      * Class members.
@@ -215,18 +221,14 @@ private:
             : dds_subscriber(nullptr)
             , dds_topic(nullptr)
             , dds_datareader(nullptr)
-            , dynamic_data(nullptr)
             , type(dynamic_type)
-            , data_mtx()
         {
         }
 
         ::fastdds::dds::Subscriber* dds_subscriber;
         ::fastdds::dds::Topic* dds_topic;
         ::fastdds::dds::DataReader* dds_datareader;
-        fastrtps::types::DynamicData* dynamic_data;
         const xtypes::DynamicType& type;
-        std::mutex data_mtx;
     };
     RequestEntities request_entities_;
 
@@ -237,66 +239,69 @@ private:
             : dds_publisher(nullptr)
             , dds_topic(nullptr)
             , dds_datawriter(nullptr)
-            , dynamic_data(nullptr)
             , type(dynamic_type)
-            , data_mtx()
         {
         }
 
         ::fastdds::dds::Publisher* dds_publisher;
         ::fastdds::dds::Topic* dds_topic;
         ::fastdds::dds::DataWriter* dds_datawriter;
-        fastrtps::types::DynamicData* dynamic_data;
         const xtypes::DynamicType& type;
-        std::mutex data_mtx;
     };
     ReplyEntities reply_entities_;
 
-    struct SampleIdentityComparator
-    {
-        bool operator () (
-                const fastrtps::rtps::SampleIdentity lha,
-                const fastrtps::rtps::SampleIdentity rha) const
-        {
-            if (lha.writer_guid() < rha.writer_guid())
-            {
-                return true;
-            }
-            if (rha.writer_guid() < lha.writer_guid()) // operator > doesn't exists for GUID_t
-            {
-                return false;
-            }
-            if (lha.sequence_number() < rha.sequence_number())
-            {
-                return true;
-            }
-            return false;
-        }
+    /**
+     * Pool of the *xtypes* requests received from DDS.
+     * They are only kept for reuse if the type contains no sequences nor maps.
+     */
+    ObjectPool<::xtypes::DynamicData> received_pool_;
 
-    };
+    /**
+     * Pool of the *Fast DDS* requests taken from the datareader, handed over to the reception workers.
+     */
+    ObjectPool<fastrtps::types::DynamicData> taken_pool_;
 
-    std::map<std::string, ServiceClientSystem::RequestCallback*> callbacks_;
+    /**
+     * Pool of the *Fast DDS* replies written to the datawriter, so that several replies can be sent at once.
+     */
+    ObjectPool<fastrtps::types::DynamicData> reply_pool_;
 
-    std::map<std::string, std::shared_ptr<NavigationNode> > member_tree_;
-    std::map<std::string, std::string> type_to_discriminator_;
-    std::map<std::string, std::string> request_reply_;
-    std::vector<std::string> member_types_;
-    std::map<eprosima::fastrtps::rtps::SampleIdentity,
-            std::string, SampleIdentityComparator> reply_id_type_;
+    /**
+     * Configured request type, with the member of the request and reply types that holds it,
+     * and the callback that handles it.
+     */
+    struct RequestRoute
+    {
+        MemberPath request_path;
+        ServiceClientSystem::RequestCallback* callback;
+        MemberPath reply_path;
+    };
 
-    std::mutex mtx_;
+    /**
+     * Handle given to *Integration Service* for each request, and received back with its reply.
+     */
+    struct CallHandle
+    {
+        fastrtps::rtps::SampleIdentity sample_id;
+        const RequestRoute* route;
+    };
+
+    /**
+     * The routes are referenced by the call handles, so they must not be moved when new ones are added.
+     */
+    std::deque<RequestRoute> request_routes_;
 
     std::mutex matched_mtx_;
-    uint8_t pub_sub_matched_;
+    std::condition_variable matched_cv_;
+    bool request_matched_;
+    bool reply_matched_;
+    bool stopping_;
 
-    std::map<std::thread::id, std::thread*> reception_threads_;
-    bool stop_cleaner_;
-    std::vector<std::thread::id> finished_threads_;
-    std::mutex cleaner_mtx_;
-    std::condition_variable cleaner_cv_;
-    std::thread cleaner_thread_;
+    std::shared_ptr<TopicMetrics> metrics_;
 
     utils::Logger logger_;
+
+    WorkerPool reception_pool_;
 };
 
 } //namespace fastdds
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_FASTDDS__INTERNAL__CONCURRENTREGISTRY_HPP_
+#define _IS_SH_FASTDDS__INTERNAL__CONCURRENTREGISTRY_HPP_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+/**
+ * @class ConcurrentRegistry
+ *        Read-mostly map from names to values, which can be used from several threads at once.
+ *
+ *        Readers work on an immutable snapshot of the map, so they never wait for each other nor
+ *        for a writer. Writers, which are expected to be rare (e.g. while creating the
+ *        entities at startup), copy the current snapshot, add their entry and publish the copy.
+ *        Entries are never modified nor removed once published.
+ *
+ * @tparam T The type of the stored values. It is copied out of the registry on each lookup,
+ *         so it is meant to be a pointer or a smart pointer.
+ */
+template<typename T>
+class ConcurrentRegistry
+{
+public:
+
+    /**
+     * @brief Construct a new, empty, ConcurrentRegistry object.
+     */
+    ConcurrentRegistry()
+        : entries_(std::make_shared<const Map>())
+    {
+    }
+
+    /**
+     * @brief ConcurrentRegistry shall not be copy constructible.
+     */
+    ConcurrentRegistry(
+            const ConcurrentRegistry& /*rhs*/) = delete;
+
+    /**
+     * @brief ConcurrentRegistry shall not be copy assignable.
+     */
+    ConcurrentRegistry& operator = (
+            const ConcurrentRegistry& /*rhs*/) = delete;
+
+    /**
+     * @brief ConcurrentRegistry shall not be move constructible.
+     */
+    ConcurrentRegistry(
+            ConcurrentRegistry&& /*rhs*/) = delete;
+
+    /**
+     * @brief ConcurrentRegistry shall not be move assignable.
+     */
+    ConcurrentRegistry& operator = (
+            ConcurrentRegistry&& /*rhs*/) = delete;
+
+    /**
+     * @brief Look for the value registered under a name.
+     *
+     * @param[in] name The name to look for.
+     *
+     * @param[out] value The registered value, only modified if it was found.
+     *
+     * @returns `true` if the name was registered.
+     */
+    bool find(
+            const std::string& name,
+            T& value) const
+    {
+        std::shared_ptr<const Map> entries = std::atomic_load(&entries_);
+        auto it = entries->find(name);
+        if (it == entries->end())
+        {
+            return false;
+        }
+
+        value = it->second;
+        return true;
+    }
+
+    /**
+     * @brief Register a value under a name, unless the name was already registered.
+     *
+     * @param[in] name The name of the value.
+     *
+     * @param[in] value The value to register.
+     *
+     * @returns The value registered under the name, which is the previous one if there was any.
+     */
+    T emplace(
+            const std::string& name,
+            T value)
+    {
+        std::unique_lock<std::mutex> lock(write_mtx_);
+
+        std::shared_ptr<const Map> entries = std::atomic_load(&entries_);
+        auto it = entries->find(name);
+        if (it != entries->end())
+        {
+            return it->second;
+        }
+
+        std::shared_ptr<Map> updated = std::make_shared<Map>(*entries);
+        T result = updated->emplace(name, std::move(value)).first->second;
+        std::atomic_store(&entries_, std::shared_ptr<const Map>(std::move(updated)));
+        return result;
+    }
+
+private:
+
+    using Map = std::unordered_map<std::string, T>;
+
+    /**
+     * Class members.
+     */
+    std::shared_ptr<const Map> entries_;
+    std::mutex write_mtx_;
+};
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_FASTDDS__INTERNAL__CONCURRENTREGISTRY_HPP_
@@ -22,6 +22,7 @@
 #include <fastrtps/types/DynamicTypeBuilderFactory.h>
 #include <fastrtps/types/MemberDescriptor.h>
 
+#include <mutex>
 #include <sstream>
 #include <stack>
 
@@ -38,285 +39,72 @@ namespace xtypes = eprosima::xtypes;
 using namespace eprosima::fastrtps;
 using namespace eprosima::fastrtps::types;
 
-std::map<std::string, ::xtypes::DynamicType::Ptr> Conversion::types_;
-std::map<std::string, DynamicPubSubType*> Conversion::registered_types_;
-std::map<std::string, DynamicTypeBuilder_ptr> Conversion::builders_;
+namespace {
 
-// Static member initialization
-utils::Logger NavigationNode::logger_("is::sh::FastDDS::Conversion::NavigationNode");
-
-std::string NavigationNode::get_path()
+/*
+ * Helpers for the bulk conversion of sequences and arrays of primitive types.
+ * The xtypes side is read or written at once, as a contiguous std::vector, and the Fast DDS elements are
+ * accessed through their consecutive MemberIds, without resolving the element type for each of them.
+ */
+template<typename T, typename U>
+void copy_primitives_to_fastdds(
+        ::xtypes::ReadableDynamicDataRef from,
+        DynamicData* to,
+        bool is_sequence,
+        MemberId first_id,
+        ResponseCode (DynamicData::* setter)(U, MemberId))
 {
-    using wt = std::weak_ptr<NavigationNode>;
-    if (!parent_node.owner_before(wt{}) && !wt{}
-            .owner_before(parent_node)) // parent_node == nullptr
-    {
-        return type_name;
-    }
-    return parent_node.lock()->get_path() + "." + member_name;
-}
+    const std::vector<T> values = from.as_vector<T>();
 
-std::string NavigationNode::get_type(
-        std::map<std::string, std::shared_ptr<NavigationNode> > map_nodes,
-        const std::string& full_path)
-{
-    if (full_path.find(".") == std::string::npos)
+    if (is_sequence)
     {
-        if (map_nodes.count(full_path) > 0)
+        MemberId id;
+        for (const T& value : values)
         {
-            return map_nodes[full_path]->type_name;
+            to->insert_sequence_data(id);
+            (to->*setter)(static_cast<U>(value), id);
         }
-        return full_path;
-    }
-
-    std::string root = full_path.substr(0, full_path.find("."));
-
-    if (map_nodes.count(root) > 0)
-    {
-        return get_type(map_nodes[root], full_path.substr(full_path.find(".") + 1));
-    }
-
-    return "";
-}
-
-std::string NavigationNode::get_type(
-        std::shared_ptr<NavigationNode> root,
-        const std::string& full_path)
-{
-    if (full_path.empty() || full_path.find(".") == std::string::npos)
-    {
-        return root->type_name;
     }
-
-    std::string member = full_path.substr(0, full_path.find("."));
-
-    if (root->member_node.count(member) > 0)
+    else
     {
-        std::string path = full_path.substr(full_path.find(".") + 1);
-        if (path.find(".") == std::string::npos)
-        {
-            return root->member_node[member]->type_name;
-        }
-        else
+        for (size_t idx = 0; idx < values.size(); ++idx)
         {
-            return get_type(root->member_node[member], path);
+            (to->*setter)(static_cast<U>(values[idx]), first_id + static_cast<MemberId>(idx));
         }
     }
-    return "";
 }
 
-std::shared_ptr<NavigationNode> NavigationNode::fill_root_node(
-        std::shared_ptr<NavigationNode> root,
-        const ::xtypes::DynamicType& type,
-        const std::string& full_path)
+template<typename T, typename U>
+ResponseCode copy_primitives_to_xtypes(
+        const DynamicData* from,
+        ::xtypes::WritableDynamicDataRef to,
+        MemberId first_id,
+        uint32_t count,
+        ResponseCode (DynamicData::* getter)(U&, MemberId) const)
 {
-    std::string type_name;
-    std::string path;
-    if (full_path.find(".") == std::string::npos)
-    {
-        type_name = full_path;
-        path = "";
-    }
-    else
-    {
-        type_name = full_path.substr(0, full_path.find("."));
-        path = full_path.substr(full_path.find(".") + 1);
-    }
-
-    if (type_name != type.name())
-    {
-        logger_ << utils::Logger::Level::ERROR
-                << "Attempting to create a root navigation node from a type with different name."
-                << std::endl;
-
-        return root;
-    }
+    std::vector<T> values(count);
+    U value;
 
-    if (!path.empty())
+    for (uint32_t idx = 0; idx < count; ++idx)
     {
-        std::string member;
-
-        if (path.find(".") == std::string::npos)
-        {
-            member = path;
-            path = "";
-        }
-        else
-        {
-            member = path.substr(0, path.find("."));
-            path = path.substr(path.find(".") + 1);
-        }
-
-        if (!type.is_aggregation_type())
-        {
-            logger_ << utils::Logger::Level::ERROR
-                    << "Attempting to create a root navigation node from a non-aggregated type."
-                    << std::endl;
-
-            return root;
-        }
-
-        const ::xtypes::AggregationType& aggr_type = static_cast<const ::xtypes::AggregationType&>(type);
-
-        if (!aggr_type.has_member(member))
-        {
-            logger_ << utils::Logger::Level::ERROR
-                    << "Type \"" << type_name << "\" doesn't have a member named \""
-                    << member << "\"." << std::endl;
-
-            return root;
-        }
-
-        std::shared_ptr<NavigationNode> member_node;
-        const ::xtypes::Member& type_member = aggr_type.member(member);
-        if (root->member_node.count(member) > 0)
-        {
-            member_node = root->member_node[member];
-        }
-        else
-        {
-            member_node = std::make_shared<NavigationNode>();
-            member_node->member_name = member;
-            member_node->type_name = type_member.type().name();
-            member_node->parent_node = root;
-            root->member_node[member] = member_node;
-        }
-
-        if (!path.empty())
+        ResponseCode ret = (from->*getter)(value, first_id + idx);
+        if (ret != ResponseCode::RETCODE_OK)
         {
-            fill_member_node(member_node, type_member.type(), path);
+            return ret;
         }
+        values[idx] = static_cast<T>(value);
     }
 
-    root->type_name = type.name();
-    return root;
-}
-
-void NavigationNode::fill_member_node(
-        std::shared_ptr<NavigationNode> node,
-        const ::xtypes::DynamicType& type,
-        const std::string& full_path)
-{
-    std::string member;
-    std::string path;
-
-    if (!type.is_aggregation_type())
-    {
-        logger_ << utils::Logger::Level::ERROR
-                << "Member " << node->member_name << " isn't an aggregated type." << std::endl;
-
-        return;
-    }
-
-    const ::xtypes::AggregationType& aggr_type = static_cast<const ::xtypes::AggregationType&>(type);
-
-    if (full_path.find(".") == std::string::npos)
-    {
-        member = full_path;
-        path = "";
-    }
-    else
-    {
-        member = full_path.substr(0, full_path.find("."));
-        path = full_path.substr(full_path.find(".") + 1);
-    }
-
-    if (!aggr_type.has_member(member))
-    {
-        logger_ << utils::Logger::Level::ERROR
-                << "Member \"" << node->member_name << "\" of type \"" << node->type_name
-                << "\" doesn't have a member named \"" << member << "\"." << std::endl;
-
-        return;
-    }
-
-    std::shared_ptr<NavigationNode> member_node;
-    const ::xtypes::Member& type_member = aggr_type.member(member);
-
-    if (node->member_node.count(member) > 0)
-    {
-        member_node = node->member_node[member];
-    }
-    else
-    {
-        member_node = std::make_shared<NavigationNode>();
-        member_node->member_name = member;
-        member_node->type_name = type_member.type().name();
-        member_node->parent_node = node;
-        node->member_node[member] = member_node;
-    }
-
-    if (!path.empty())
-    {
-        fill_member_node(member_node, type_member.type(), path);
-    }
-}
-
-std::shared_ptr<NavigationNode> NavigationNode::get_discriminator(
-        const std::map<std::string, std::shared_ptr<NavigationNode> >& member_map,
-        const ::xtypes::DynamicData& data,
-        const std::vector<std::string>& member_types)
-{
-    const std::string& type_name = data.type().name();
-
-    if (member_map.count(type_name) == 0)
-    {
-        auto result = std::make_shared<NavigationNode>();
-        result->type_name = type_name;
-        return result;
-    }
-
-    if (std::find(member_types.begin(), member_types.end(), type_name) != member_types.end())
-    {
-        return member_map.at(type_name);
-    }
-
-    return get_discriminator(member_map.at(type_name), data.ref(), member_types);
+    to = values;
+    return ResponseCode::RETCODE_OK;
 }
 
-std::shared_ptr<NavigationNode> NavigationNode::get_discriminator(
-        std::shared_ptr<NavigationNode> node,
-        ::xtypes::ReadableDynamicDataRef data,
-        const std::vector<std::string>& member_types)
-{
-    const std::string& type_name = data.type().name();
-    if (std::find(member_types.begin(), member_types.end(), type_name) != member_types.end())
-    {
-        return node;
-    }
-
-    if (data.type().is_aggregation_type())
-    {
-        const ::xtypes::AggregationType& aggr = static_cast<const ::xtypes::AggregationType&>(data.type());
-        std::shared_ptr<NavigationNode> result;
-        if (aggr.kind() == ::xtypes::TypeKind::UNION_TYPE)
-        {
-            std::string member = data.current_case().name();
-            if (node->member_node.count(member) > 0)
-            {
-                result =
-                        get_discriminator(node->member_node[member], data[member], member_types);
-            }
-        }
-        else
-        {
-            for (auto& n : node->member_node)
-            {
-                if (aggr.has_member(n.first))
-                {
-                    result = get_discriminator(n.second, data[n.first], member_types);
-                    if (result)
-                    {
-                        break;
-                    }
-                }
-            }
-        }
-        return result;
-    }
+} //  anonymous namespace
 
-    return nullptr;
-}
+ConcurrentRegistry<::xtypes::DynamicType::Ptr> Conversion::types_;
+ConcurrentRegistry<DynamicPubSubType*> Conversion::registered_types_;
+ConcurrentRegistry<DynamicTypeBuilder_ptr> Conversion::builders_;
+ConcurrentRegistry<std::shared_ptr<const ConversionPlan> > Conversion::plans_;
 
 // Static member initialization
 utils::Logger Conversion::logger_("is::sh::FastDDS::Conversion");
@@ -420,6 +208,87 @@ void Conversion::set_primitive_data(
     }
 }
 
+bool Conversion::set_primitive_collection_data(
+        ::xtypes::ReadableDynamicDataRef from,
+        DynamicData* to,
+        ::xtypes::TypeKind kind,
+        bool is_sequence,
+        MemberId first_id)
+{
+    switch (kind)
+    {
+        case ::xtypes::TypeKind::CHAR_8_TYPE:
+            copy_primitives_to_fastdds<char, char>(
+                from, to, is_sequence, first_id, &DynamicData::set_char8_value);
+            break;
+        case ::xtypes::TypeKind::UINT_8_TYPE:
+            if (is_sequence)
+            {
+                copy_primitives_to_fastdds<uint8_t, rtps::octet>(
+                    from, to, is_sequence, first_id, &DynamicData::set_byte_value);
+            }
+            else
+            {
+                copy_primitives_to_fastdds<uint8_t, uint8_t>(
+                    from, to, is_sequence, first_id, &DynamicData::set_uint8_value);
+            }
+            break;
+        case ::xtypes::TypeKind::INT_8_TYPE:
+            if (is_sequence)
+            {
+                copy_primitives_to_fastdds<int8_t, rtps::octet>(
+                    from, to, is_sequence, first_id, &DynamicData::set_byte_value);
+            }
+            else
+            {
+                copy_primitives_to_fastdds<int8_t, int8_t>(
+                    from, to, is_sequence, first_id, &DynamicData::set_int8_value);
+            }
+            break;
+        case ::xtypes::TypeKind::INT_16_TYPE:
+            copy_primitives_to_fastdds<int16_t, int16_t>(
+                from, to, is_sequence, first_id, &DynamicData::set_int16_value);
+            break;
+        case ::xtypes::TypeKind::UINT_16_TYPE:
+            copy_primitives_to_fastdds<uint16_t, uint16_t>(
+                from, to, is_sequence, first_id, &DynamicData::set_uint16_value);
+            break;
+        case ::xtypes::TypeKind::INT_32_TYPE:
+            copy_primitives_to_fastdds<int32_t, int32_t>(
+                from, to, is_sequence, first_id, &DynamicData::set_int32_value);
+            break;
+        case ::xtypes::TypeKind::UINT_32_TYPE:
+            copy_primitives_to_fastdds<uint32_t, uint32_t>(
+                from, to, is_sequence, first_id, &DynamicData::set_uint32_value);
+            break;
+        case ::xtypes::TypeKind::INT_64_TYPE:
+            copy_primitives_to_fastdds<int64_t, int64_t>(
+                from, to, is_sequence, first_id, &DynamicData::set_int64_value);
+            break;
+        case ::xtypes::TypeKind::UINT_64_TYPE:
+            copy_primitives_to_fastdds<uint64_t, uint64_t>(
+                from, to, is_sequence, first_id, &DynamicData::set_uint64_value);
+            break;
+        case ::xtypes::TypeKind::FLOAT_32_TYPE:
+            copy_primitives_to_fastdds<float, float>(
+                from, to, is_sequence, first_id, &DynamicData::set_float32_value);
+            break;
+        case ::xtypes::TypeKind::FLOAT_64_TYPE:
+            copy_primitives_to_fastdds<double, double>(
+                from, to, is_sequence, first_id, &DynamicData::set_float64_value);
+            break;
+        case ::xtypes::TypeKind::FLOAT_128_TYPE:
+            copy_primitives_to_fastdds<long double, long double>(
+                from, to, is_sequence, first_id, &DynamicData::set_float128_value);
+            break;
+        default:
+            // Not a plain primitive type (bool, wide characters, strings, enums, constructed types...)
+            return false;
+    }
+
+    return true;
+}
+
 void Conversion::set_array_data(
         xtypes::ReadableDynamicDataRef from,
         DynamicData* to,
@@ -430,6 +299,23 @@ void Conversion::set_array_data(
     DynamicDataFactory* factory = DynamicDataFactory::get_instance();
     MemberId id;
 
+    // Innermost dimension of primitives: its elements have consecutive MemberIds
+    if (inner_type.is_primitive_type())
+    {
+        std::vector<uint32_t> first_indexes = indexes;
+        first_indexes.push_back(0);
+        if (set_primitive_collection_data(from, to, inner_type.kind(), false, to->get_array_index(first_indexes)))
+        {
+            return;
+        }
+    }
+
+    std::shared_ptr<const ConversionPlan> plan;
+    if (inner_type.kind() == ::xtypes::TypeKind::STRUCTURE_TYPE)
+    {
+        plan = get_plan(static_cast<const ::xtypes::StructType&>(inner_type));
+    }
+
     for (uint32_t idx = 0; idx < from.size(); ++idx)
     {
         std::vector<uint32_t> new_indexes = indexes;
@@ -536,7 +422,7 @@ void Conversion::set_array_data(
                 DynamicTypeBuilder_ptr builder = get_builder(from[idx].type()); // The inner struct builder
                 DynamicTypeBuilder* builder_ptr = static_cast<DynamicTypeBuilder*>(builder.get());
                 DynamicData* st_data = factory->create_data(builder_ptr->build());
-                set_struct_data(from[idx], st_data);
+                set_struct_data(from[idx], st_data, *plan);
                 to->set_complex_value(st_data, id);
                 break;
             }
@@ -564,13 +450,26 @@ void Conversion::set_sequence_data(
         DynamicData* to)
 {
     const ::xtypes::SequenceType& type = static_cast<const ::xtypes::SequenceType&>(from.type());
+    const ::xtypes::DynamicType& inner_type = resolve_type(type.content_type());
     MemberId id;
     DynamicDataFactory* factory = DynamicDataFactory::get_instance();
     to->clear_all_values();
+
+    if (set_primitive_collection_data(from, to, inner_type.kind(), true, MEMBER_ID_INVALID))
+    {
+        return;
+    }
+
+    std::shared_ptr<const ConversionPlan> plan;
+    if (inner_type.kind() == ::xtypes::TypeKind::STRUCTURE_TYPE)
+    {
+        plan = get_plan(static_cast<const ::xtypes::StructType&>(inner_type));
+    }
+
     for (uint32_t idx = 0; idx < from.size(); ++idx)
     {
         to->insert_sequence_data(id);
-        switch (resolve_type(type.content_type()).kind())
+        switch (inner_type.kind())
         {
             case ::xtypes::TypeKind::BOOLEAN_TYPE:
                 to->set_bool_value(from[idx].value<bool>(), id);
@@ -658,7 +557,7 @@ void Conversion::set_sequence_data(
                 DynamicTypeBuilder_ptr builder = get_builder(from[idx].type()); // The inner struct builder
                 DynamicTypeBuilder* builder_ptr = static_cast<DynamicTypeBuilder*>(builder.get());
                 DynamicData* st_data = factory->create_data(builder_ptr->build());
-                set_struct_data(from[idx], st_data);
+                set_struct_data(from[idx], st_data, *plan);
                 to->set_complex_value(st_data, id);
                 break;
             }
@@ -930,14 +829,19 @@ bool Conversion::set_struct_data(
         ::xtypes::ReadableDynamicDataRef input,
         DynamicData* output)
 {
-    std::stringstream ss;
+    const ::xtypes::StructType& type = static_cast<const ::xtypes::StructType&>(resolve_type(input.type()));
 
-    const ::xtypes::StructType& type = static_cast<const ::xtypes::StructType&>(input.type());
+    return set_struct_data(input, output, *get_plan(type));
+}
 
-    for (const ::xtypes::Member& member : type.members())
+bool Conversion::set_struct_data(
+        ::xtypes::ReadableDynamicDataRef input,
+        DynamicData* output,
+        const ConversionPlan& plan)
+{
+    for (const ConversionPlan::Step& step : plan.steps)
     {
-        MemberId id = output->get_member_id_by_name(member.name());
-        switch (resolve_type(member.type()).kind())
+        switch (step.kind)
         {
             case ::xtypes::TypeKind::BOOLEAN_TYPE:
             case ::xtypes::TypeKind::CHAR_8_TYPE:
@@ -958,47 +862,47 @@ bool Conversion::set_struct_data(
             case ::xtypes::TypeKind::WSTRING_TYPE:
             case ::xtypes::TypeKind::ENUMERATION_TYPE:
             {
-                set_primitive_data(input[member.name()], output, id);
+                set_primitive_data(input[step.member_index], output, step.id);
                 break;
             }
             case ::xtypes::TypeKind::ARRAY_TYPE:
             {
-                DynamicData* array_data = output->loan_value(id);
-                set_array_data(input[member.name()], array_data, std::vector<uint32_t>());
+                DynamicData* array_data = output->loan_value(step.id);
+                set_array_data(input[step.member_index], array_data, std::vector<uint32_t>());
                 output->return_loaned_value(array_data);
                 break;
             }
             case ::xtypes::TypeKind::SEQUENCE_TYPE:
             {
-                DynamicData* seq_data = output->loan_value(id);
-                set_sequence_data(input[member.name()], seq_data);
+                DynamicData* seq_data = output->loan_value(step.id);
+                set_sequence_data(input[step.member_index], seq_data);
                 output->return_loaned_value(seq_data);
                 break;
             }
             case ::xtypes::TypeKind::MAP_TYPE:
             {
-                DynamicData* seq_data = output->loan_value(id);
-                set_map_data(input[member.name()], seq_data);
+                DynamicData* seq_data = output->loan_value(step.id);
+                set_map_data(input[step.member_index], seq_data);
                 output->return_loaned_value(seq_data);
                 break;
             }
             case ::xtypes::TypeKind::STRUCTURE_TYPE:
             {
-                DynamicData* st_data = output->loan_value(id);
-                set_struct_data(input[member.name()], st_data);
+                DynamicData* st_data = output->loan_value(step.id);
+                set_struct_data(input[step.member_index], st_data, *step.plan);
                 output->return_loaned_value(st_data);
                 break;
             }
             case ::xtypes::TypeKind::UNION_TYPE:
             {
-                DynamicData* st_data = output->loan_value(id);
-                set_union_data(input[member.name()], st_data);
+                DynamicData* st_data = output->loan_value(step.id);
+                set_union_data(input[step.member_index], st_data);
                 output->return_loaned_value(st_data);
                 break;
             }
             default:
                 logger_ << utils::Logger::Level::ERROR
-                        << "Unsupported type: '" << member.type().name() << "'" << std::endl;
+                        << "Unsupported type: '" << input[step.member_index].type().name() << "'" << std::endl;
 
         }
     }
@@ -1126,19 +1030,105 @@ bool Conversion::set_union_data(
     return true;
 }
 
+bool Conversion::set_primitive_collection_data(
+        const DynamicData* from,
+        ::xtypes::WritableDynamicDataRef to,
+        ::xtypes::TypeKind kind,
+        MemberId first_id,
+        uint32_t count)
+{
+    ResponseCode ret = ResponseCode::RETCODE_ERROR;
+
+    switch (kind)
+    {
+        case ::xtypes::TypeKind::CHAR_8_TYPE:
+            ret = copy_primitives_to_xtypes<char, char>(
+                from, to, first_id, count, &DynamicData::get_char8_value);
+            break;
+        case ::xtypes::TypeKind::UINT_8_TYPE:
+            ret = copy_primitives_to_xtypes<uint8_t, uint8_t>(
+                from, to, first_id, count, &DynamicData::get_uint8_value);
+            break;
+        case ::xtypes::TypeKind::INT_8_TYPE:
+            ret = copy_primitives_to_xtypes<int8_t, int8_t>(
+                from, to, first_id, count, &DynamicData::get_int8_value);
+            break;
+        case ::xtypes::TypeKind::INT_16_TYPE:
+            ret = copy_primitives_to_xtypes<int16_t, int16_t>(
+                from, to, first_id, count, &DynamicData::get_int16_value);
+            break;
+        case ::xtypes::TypeKind::UINT_16_TYPE:
+            ret = copy_primitives_to_xtypes<uint16_t, uint16_t>(
+                from, to, first_id, count, &DynamicData::get_uint16_value);
+            break;
+        case ::xtypes::TypeKind::INT_32_TYPE:
+            ret = copy_primitives_to_xtypes<int32_t, int32_t>(
+                from, to, first_id, count, &DynamicData::get_int32_value);
+            break;
+        case ::xtypes::TypeKind::UINT_32_TYPE:
+            ret = copy_primitives_to_xtypes<uint32_t, uint32_t>(
+                from, to, first_id, count, &DynamicData::get_uint32_value);
+            break;
+        case ::xtypes::TypeKind::INT_64_TYPE:
+            ret = copy_primitives_to_xtypes<int64_t, int64_t>(
+                from, to, first_id, count, &DynamicData::get_int64_value);
+            break;
+        case ::xtypes::TypeKind::UINT_64_TYPE:
+            ret = copy_primitives_to_xtypes<uint64_t, uint64_t>(
+                from, to, first_id, count, &DynamicData::get_uint64_value);
+            break;
+        case ::xtypes::TypeKind::FLOAT_32_TYPE:
+            ret = copy_primitives_to_xtypes<float, float>(
+                from, to, first_id, count, &DynamicData::get_float32_value);
+            break;
+        case ::xtypes::TypeKind::FLOAT_64_TYPE:
+            ret = copy_primitives_to_xtypes<double, double>(
+                from, to, first_id, count, &DynamicData::get_float64_value);
+            break;
+        case ::xtypes::TypeKind::FLOAT_128_TYPE:
+            ret = copy_primitives_to_xtypes<long double, long double>(
+                from, to, first_id, count, &DynamicData::get_float128_value);
+            break;
+        default:
+            // Not a plain primitive type (bool, wide characters, strings, enums, constructed types...)
+            return false;
+    }
+
+    if (ret != ResponseCode::RETCODE_OK)
+    {
+        logger_ << utils::Logger::Level::ERROR
+                << "Error parsing from dynamic type '"
+                << from->get_name() << "'" << std::endl;
+    }
+
+    return true;
+}
+
 void Conversion::set_sequence_data(
         const DynamicData* c_from,
         ::xtypes::WritableDynamicDataRef to)
 {
     const ::xtypes::SequenceType& type = static_cast<const ::xtypes::SequenceType&>(to.type());
+    const ::xtypes::DynamicType& inner_type = resolve_type(type.content_type());
     DynamicData* from = const_cast<DynamicData*>(c_from);
 
+    if (set_primitive_collection_data(c_from, to, inner_type.kind(), 0, c_from->get_item_count()))
+    {
+        return;
+    }
+
+    std::shared_ptr<const ConversionPlan> plan;
+    if (inner_type.kind() == ::xtypes::TypeKind::STRUCTURE_TYPE)
+    {
+        plan = get_plan(static_cast<const ::xtypes::StructType&>(inner_type));
+    }
+
     for (uint32_t idx = 0; idx < c_from->get_item_count(); ++idx)
     {
         MemberId id = idx;
         ResponseCode ret = ResponseCode::RETCODE_ERROR;
 
-        switch (resolve_type(type.content_type()).kind())
+        switch (inner_type.kind())
         {
             case ::xtypes::TypeKind::BOOLEAN_TYPE:
             {
@@ -1294,7 +1284,7 @@ void Conversion::set_sequence_data(
             {
                 DynamicData* st = from->loan_value(id);
                 ::xtypes::DynamicData xtypes_st(type.content_type());
-                set_struct_data(st, xtypes_st.ref());
+                set_struct_data(st, xtypes_st.ref(), *plan);
                 from->return_loaned_value(st);
                 to.push(xtypes_st);
                 ret = ResponseCode::RETCODE_OK;
@@ -1725,6 +1715,24 @@ void Conversion::set_array_data(
     DynamicData* from = const_cast<DynamicData*>(c_from);
     MemberId id;
 
+    // Innermost dimension of primitives: its elements have consecutive MemberIds
+    if (resolve_type(inner_type).is_primitive_type())
+    {
+        std::vector<uint32_t> first_indexes = indexes;
+        first_indexes.push_back(0);
+        if (set_primitive_collection_data(c_from, to, resolve_type(inner_type).kind(),
+                from->get_array_index(first_indexes), type.dimension()))
+        {
+            return;
+        }
+    }
+
+    std::shared_ptr<const ConversionPlan> plan;
+    if (resolve_type(inner_type).kind() == ::xtypes::TypeKind::STRUCTURE_TYPE)
+    {
+        plan = get_plan(static_cast<const ::xtypes::StructType&>(resolve_type(inner_type)));
+    }
+
     for (uint32_t idx = 0; idx < type.dimension(); ++idx)
     {
         std::vector<uint32_t> new_indexes = indexes;
@@ -1904,7 +1912,7 @@ void Conversion::set_array_data(
                 id = from->get_array_index(new_indexes);
                 DynamicData* st = from->loan_value(id);
                 ::xtypes::DynamicData xtypes_st(type.content_type());
-                set_struct_data(st, xtypes_st.ref());
+                set_struct_data(st, xtypes_st.ref(), *plan);
                 from->return_loaned_value(st);
                 to[idx] = xtypes_st;
                 ret = ResponseCode::RETCODE_OK;
@@ -1972,220 +1980,215 @@ bool Conversion::set_struct_data(
         const DynamicData* c_input,
         ::xtypes::WritableDynamicDataRef output)
 {
-    std::stringstream ss;
-    uint32_t id = 0;
-    uint32_t i = 0;
-    MemberDescriptor descriptor;
+    const ::xtypes::StructType& type = static_cast<const ::xtypes::StructType&>(resolve_type(output.type()));
 
+    return set_struct_data(c_input, output, *get_plan(type));
+}
+
+bool Conversion::set_struct_data(
+        const DynamicData* c_input,
+        ::xtypes::WritableDynamicDataRef output,
+        const ConversionPlan& plan)
+{
     // We promise to not modify it, but we need it non-const, so we can call loan_value freely.
     DynamicData* input = const_cast<DynamicData*>(c_input);
 
-    while (id != MEMBER_ID_INVALID)
+    for (const ConversionPlan::Step& step : plan.steps)
     {
-        id = input->get_member_id_at_index(i);
+        ::xtypes::WritableDynamicDataRef member = output[step.member_index];
         ResponseCode ret = ResponseCode::RETCODE_ERROR;
 
-        if (id != MEMBER_ID_INVALID)
+        switch (step.dds_kind)
         {
-            ret = input->get_descriptor(descriptor, id);
-
-            if (ret == ResponseCode::RETCODE_OK)
+            case types::TK_BOOLEAN:
             {
-                switch (resolve_type(descriptor.get_type()))
-                {
-                    case types::TK_BOOLEAN:
-                    {
-                        bool value;
-                        ret = input->get_bool_value(value, id);
-                        output[descriptor.get_name()].value<bool>(value ? true : false);
-                        break;
-                    }
-                    case types::TK_BYTE:
-                    {
-                        uint8_t value;
-                        ret = input->get_byte_value(value, id);
-                        switch (output[descriptor.get_name()].type().kind())
-                        {
-                            case ::xtypes::TypeKind::UINT_8_TYPE:
-                                output[descriptor.get_name()].value<uint8_t>(value);
-                                break;
-                            case ::xtypes::TypeKind::CHAR_8_TYPE:
-                                output[descriptor.get_name()].value<char>(static_cast<char>(value));
-                                break;
-                            case ::xtypes::TypeKind::INT_8_TYPE:
-                                output[descriptor.get_name()].value<int8_t>(static_cast<int8_t>(value));
-                                break;
-                            default:
-                                logger_ << utils::Logger::Level::ERROR
-                                        << "Error parsing from dynamic type '"
-                                        << input->get_name() << "'" << std::endl;
-                        }
-                        break;
-                    }
-                    case types::TK_INT16:
-                    {
-                        int16_t value;
-                        ret = input->get_int16_value(value, id);
-                        output[descriptor.get_name()].value<int16_t>(value);
-                        break;
-                    }
-                    case types::TK_INT32:
-                    {
-                        int32_t value;
-                        ret = input->get_int32_value(value, id);
-                        output[descriptor.get_name()].value<int32_t>(value);
-                        break;
-                    }
-                    case types::TK_INT64:
-                    {
-                        int64_t value;
-                        ret = input->get_int64_value(value, id);
-                        output[descriptor.get_name()].value<int64_t>(value);
-                        break;
-                    }
-                    case types::TK_UINT16:
-                    {
-                        uint16_t value;
-                        ret = input->get_uint16_value(value, id);
-                        output[descriptor.get_name()].value<uint16_t>(value);
-                        break;
-                    }
-                    case types::TK_UINT32:
-                    {
-                        uint32_t value;
-                        ret = input->get_uint32_value(value, id);
-                        output[descriptor.get_name()].value<uint32_t>(value);
-                        break;
-                    }
-                    case types::TK_UINT64:
-                    {
-                        uint64_t value;
-                        ret = input->get_uint64_value(value, id);
-                        output[descriptor.get_name()].value<uint64_t>(value);
-                        break;
-                    }
-                    case types::TK_FLOAT32:
-                    {
-                        float value;
-                        ret = input->get_float32_value(value, id);
-                        output[descriptor.get_name()].value<float>(value);
-                        break;
-                    }
-                    case types::TK_FLOAT64:
-                    {
-                        double value;
-                        ret = input->get_float64_value(value, id);
-                        output[descriptor.get_name()].value<double>(value);
-                        break;
-                    }
-                    case types::TK_FLOAT128:
-                    {
-                        long double value;
-                        ret = input->get_float128_value(value, id);
-                        output[descriptor.get_name()].value<long double>(value);
-                        break;
-                    }
-                    case types::TK_CHAR8:
-                    {
-                        char value;
-                        ret = input->get_char8_value(value, id);
-                        output[descriptor.get_name()].value<char>(value);
-                        break;
-                    }
-                    case types::TK_CHAR16:
-                    {
-                        wchar_t value;
-                        ret = input->get_char16_value(value, id);
-                        output[descriptor.get_name()].value<wchar_t>(value);
-                        break;
-                    }
-                    case types::TK_STRING8:
-                    {
-                        std::string value;
-                        ret = input->get_string_value(value, id);
-                        output[descriptor.get_name()].value<std::string>(value);
-                        break;
-                    }
-                    case types::TK_STRING16:
-                    {
-                        std::wstring value;
-                        ret = input->get_wstring_value(value, id);
-                        output[descriptor.get_name()].value<std::wstring>(value);
-                        break;
-                    }
-                    case types::TK_ENUM:
-                    {
-                        uint32_t value;
-                        ret = input->get_enum_value(value, id);
-                        output[descriptor.get_name()].value<uint32_t>(value);
-                        break;
-                    }
-                    case types::TK_ARRAY:
-                    {
-                        DynamicData* array = input->loan_value(id);
-                        set_array_data(array, output[descriptor.get_name()], std::vector<uint32_t>());
-                        input->return_loaned_value(array);
-                        break;
-                    }
-                    case types::TK_SEQUENCE:
-                    {
-                        DynamicData* seq = input->loan_value(id);
-                        set_sequence_data(seq, output[descriptor.get_name()]);
-                        input->return_loaned_value(seq);
-                        break;
-                    }
-                    case types::TK_MAP:
-                    {
-                        DynamicData* seq = input->loan_value(id);
-                        set_map_data(seq, output[descriptor.get_name()]);
-                        input->return_loaned_value(seq);
+                bool value;
+                ret = input->get_bool_value(value, step.id);
+                member.value<bool>(value ? true : false);
+                break;
+            }
+            case types::TK_BYTE:
+            {
+                uint8_t value;
+                ret = input->get_byte_value(value, step.id);
+                switch (step.kind)
+                {
+                    case ::xtypes::TypeKind::UINT_8_TYPE:
+                        member.value<uint8_t>(value);
                         break;
-                    }
-                    case types::TK_STRUCTURE:
-                    {
-                        DynamicData* nested_msg_dds = input->loan_value(id);
-
-                        if (nested_msg_dds != nullptr)
-                        {
-                            if (set_struct_data(nested_msg_dds, output[descriptor.get_name()]))
-                            {
-                                ret = ResponseCode::RETCODE_OK;
-                            }
-                            input->return_loaned_value(nested_msg_dds);
-                        }
+                    case ::xtypes::TypeKind::CHAR_8_TYPE:
+                        member.value<char>(static_cast<char>(value));
                         break;
-                    }
-                    case types::TK_UNION:
-                    {
-                        DynamicData* nested_msg_dds = input->loan_value(id);
-
-                        if (nested_msg_dds != nullptr)
-                        {
-                            if (set_union_data(nested_msg_dds, output[descriptor.get_name()]))
-                            {
-                                ret = ResponseCode::RETCODE_OK;
-                            }
-                            input->return_loaned_value(nested_msg_dds);
-                        }
+                    case ::xtypes::TypeKind::INT_8_TYPE:
+                        member.value<int8_t>(static_cast<int8_t>(value));
                         break;
-                    }
                     default:
+                        logger_ << utils::Logger::Level::ERROR
+                                << "Error parsing from dynamic type '"
+                                << input->get_name() << "'" << std::endl;
+                }
+                break;
+            }
+            case types::TK_INT16:
+            {
+                int16_t value;
+                ret = input->get_int16_value(value, step.id);
+                member.value<int16_t>(value);
+                break;
+            }
+            case types::TK_INT32:
+            {
+                int32_t value;
+                ret = input->get_int32_value(value, step.id);
+                member.value<int32_t>(value);
+                break;
+            }
+            case types::TK_INT64:
+            {
+                int64_t value;
+                ret = input->get_int64_value(value, step.id);
+                member.value<int64_t>(value);
+                break;
+            }
+            case types::TK_UINT16:
+            {
+                uint16_t value;
+                ret = input->get_uint16_value(value, step.id);
+                member.value<uint16_t>(value);
+                break;
+            }
+            case types::TK_UINT32:
+            {
+                uint32_t value;
+                ret = input->get_uint32_value(value, step.id);
+                member.value<uint32_t>(value);
+                break;
+            }
+            case types::TK_UINT64:
+            {
+                uint64_t value;
+                ret = input->get_uint64_value(value, step.id);
+                member.value<uint64_t>(value);
+                break;
+            }
+            case types::TK_FLOAT32:
+            {
+                float value;
+                ret = input->get_float32_value(value, step.id);
+                member.value<float>(value);
+                break;
+            }
+            case types::TK_FLOAT64:
+            {
+                double value;
+                ret = input->get_float64_value(value, step.id);
+                member.value<double>(value);
+                break;
+            }
+            case types::TK_FLOAT128:
+            {
+                long double value;
+                ret = input->get_float128_value(value, step.id);
+                member.value<long double>(value);
+                break;
+            }
+            case types::TK_CHAR8:
+            {
+                char value;
+                ret = input->get_char8_value(value, step.id);
+                member.value<char>(value);
+                break;
+            }
+            case types::TK_CHAR16:
+            {
+                wchar_t value;
+                ret = input->get_char16_value(value, step.id);
+                member.value<wchar_t>(value);
+                break;
+            }
+            case types::TK_STRING8:
+            {
+                std::string value;
+                ret = input->get_string_value(value, step.id);
+                member.value<std::string>(value);
+                break;
+            }
+            case types::TK_STRING16:
+            {
+                std::wstring value;
+                ret = input->get_wstring_value(value, step.id);
+                member.value<std::wstring>(value);
+                break;
+            }
+            case types::TK_ENUM:
+            {
+                uint32_t value;
+                ret = input->get_enum_value(value, step.id);
+                member.value<uint32_t>(value);
+                break;
+            }
+            case types::TK_ARRAY:
+            {
+                DynamicData* array = input->loan_value(step.id);
+                set_array_data(array, member, std::vector<uint32_t>());
+                input->return_loaned_value(array);
+                break;
+            }
+            case types::TK_SEQUENCE:
+            {
+                DynamicData* seq = input->loan_value(step.id);
+                set_sequence_data(seq, member);
+                input->return_loaned_value(seq);
+                break;
+            }
+            case types::TK_MAP:
+            {
+                DynamicData* seq = input->loan_value(step.id);
+                set_map_data(seq, member);
+                input->return_loaned_value(seq);
+                break;
+            }
+            case types::TK_STRUCTURE:
+            {
+                DynamicData* nested_msg_dds = input->loan_value(step.id);
+
+                if (nested_msg_dds != nullptr)
+                {
+                    if (set_struct_data(nested_msg_dds, member, *step.plan))
                     {
-                        ret = ResponseCode::RETCODE_ERROR;
-                        break;
+                        ret = ResponseCode::RETCODE_OK;
                     }
+                    input->return_loaned_value(nested_msg_dds);
                 }
-
-                i++;
+                break;
             }
+            case types::TK_UNION:
+            {
+                DynamicData* nested_msg_dds = input->loan_value(step.id);
 
-            if (ret != ResponseCode::RETCODE_OK)
+                if (nested_msg_dds != nullptr)
+                {
+                    if (set_union_data(nested_msg_dds, member))
+                    {
+                        ret = ResponseCode::RETCODE_OK;
+                    }
+                    input->return_loaned_value(nested_msg_dds);
+                }
+                break;
+            }
+            default:
             {
-                logger_ << utils::Logger::Level::ERROR
-                        << "Error parsing from dynamic type '"
-                        << input->get_name() << "'" << std::endl;
+                ret = ResponseCode::RETCODE_ERROR;
+                break;
             }
         }
+
+        if (ret != ResponseCode::RETCODE_OK)
+        {
+            logger_ << utils::Logger::Level::ERROR
+                    << "Error parsing from dynamic type '"
+                    << input->get_name() << "'" << std::endl;
+        }
     }
 
     return true;
@@ -2395,35 +2398,135 @@ bool Conversion::set_union_data(
 ::xtypes::DynamicData Conversion::dynamic_data(
         const std::string& type_name)
 {
-    auto it = types_.find(type_name);
+    ::xtypes::DynamicType::Ptr type;
 
-    if (it == types_.end())
+    if (!types_.find(type_name, type))
     {
-        logger_ << utils::Logger::Level::ERROR
-                << "Error getting data from dynamic type '"
-                << type_name << "' (not registered)" << std::endl;
+        std::ostringstream err;
+        err << "Error getting data from dynamic type '" << type_name << "' (not registered)";
+
+        throw DDSMiddlewareException(logger_, err.str());
     }
 
-    return ::xtypes::DynamicData(*it->second.get());
+    return ::xtypes::DynamicData(*type.get());
 }
 
 DynamicTypeBuilder* Conversion::create_builder(
         const ::xtypes::DynamicType& type)
 {
-    if (builders_.count(type.name()) > 0)
+    DynamicTypeBuilder_ptr builder;
+    if (builders_.find(type.name(), builder))
     {
-        return static_cast<DynamicTypeBuilder*>(builders_[type.name()].get());
+        return static_cast<DynamicTypeBuilder*>(builder.get());
     }
 
-    DynamicTypeBuilder_ptr builder = get_builder(type);
+    builder = get_builder(type);
     if (builder == nullptr)
     {
         return nullptr;
     }
-    DynamicTypeBuilder* result = static_cast<DynamicTypeBuilder*>(builder.get());
-    result->set_name(convert_type_name(type.name()));
-    builders_.emplace(type.name(), std::move(builder));
-    return result;
+    builder->set_name(convert_type_name(type.name()));
+
+    // If another thread was faster, keep its builder
+    builder = builders_.emplace(type.name(), std::move(builder));
+    return static_cast<DynamicTypeBuilder*>(builder.get());
+}
+
+void Conversion::prepare_plan(
+        const ::xtypes::DynamicType& type)
+{
+    const ::xtypes::DynamicType& resolved_type = resolve_type(type);
+    if (resolved_type.kind() == ::xtypes::TypeKind::STRUCTURE_TYPE)
+    {
+        get_plan(static_cast<const ::xtypes::StructType&>(resolved_type));
+    }
+}
+
+bool Conversion::is_reusable(
+        const ::xtypes::DynamicType& type)
+{
+    const ::xtypes::DynamicType& resolved_type = resolve_type(type);
+    switch (resolved_type.kind())
+    {
+        case ::xtypes::TypeKind::SEQUENCE_TYPE:
+        case ::xtypes::TypeKind::MAP_TYPE:
+            return false;
+        case ::xtypes::TypeKind::ARRAY_TYPE:
+            return is_reusable(static_cast<const ::xtypes::ArrayType&>(resolved_type).content_type());
+        case ::xtypes::TypeKind::STRUCTURE_TYPE:
+        case ::xtypes::TypeKind::UNION_TYPE:
+        {
+            const ::xtypes::AggregationType& aggregation =
+                    static_cast<const ::xtypes::AggregationType&>(resolved_type);
+            for (const ::xtypes::Member& member : aggregation.members())
+            {
+                if (!is_reusable(member.type()))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        default:
+            return true;
+    }
+}
+
+std::shared_ptr<const ConversionPlan> Conversion::get_plan(
+        const ::xtypes::StructType& type)
+{
+    std::shared_ptr<const ConversionPlan> plan;
+    if (plans_.find(type.name(), plan))
+    {
+        return plan;
+    }
+
+    // Nested structures request their own plans while this one is built
+    plan = build_plan(type);
+
+    // If another thread was faster, keep its plan
+    return plans_.emplace(type.name(), std::move(plan));
+}
+
+std::shared_ptr<const ConversionPlan> Conversion::build_plan(
+        const ::xtypes::StructType& type)
+{
+    auto plan = std::make_shared<ConversionPlan>();
+
+    // The MemberIds are taken from an instance of the equivalent Fast DDS type
+    DynamicTypeBuilder_ptr builder = get_builder(type);
+    DynamicTypeBuilder* builder_ptr = static_cast<DynamicTypeBuilder*>(builder.get());
+    DynamicData* sample = DynamicDataFactory::get_instance()->create_data(builder_ptr->build());
+
+    plan->steps.reserve(type.members().size());
+    for (uint32_t idx = 0; idx < type.members().size(); ++idx)
+    {
+        const ::xtypes::Member& member = type.member(idx);
+        const ::xtypes::DynamicType& member_type = resolve_type(member.type());
+
+        ConversionPlan::Step step;
+        step.member_index = idx;
+        step.id = sample->get_member_id_by_name(member.name());
+        step.kind = member_type.kind();
+
+        MemberDescriptor descriptor;
+        sample->get_descriptor(descriptor, step.id);
+        step.dds_kind = resolve_type(descriptor.get_type());
+        if (step.kind == ::xtypes::TypeKind::STRUCTURE_TYPE)
+        {
+            step.plan = get_plan(static_cast<const ::xtypes::StructType&>(member_type));
+        }
+
+        plan->steps.push_back(std::move(step));
+    }
+
+    DynamicDataFactory::get_instance()->delete_data(sample);
+
+    logger_ << utils::Logger::Level::DEBUG
+            << "Built conversion plan for type '" << type.name() << "' with "
+            << plan->steps.size() << " members" << std::endl;
+
+    return plan;
 }
 
 DynamicTypeBuilder_ptr Conversion::get_builder(
@@ -2589,6 +2692,13 @@ DynamicTypeBuilder_ptr Conversion::get_builder(
                 DynamicTypeBuilder* builder = static_cast<DynamicTypeBuilder*>(member_builder.get());
                 DynamicTypeBuilder* result_ptr = static_cast<DynamicTypeBuilder*>(result.get());
                 result_ptr->add_member(static_cast<MemberId>(idx), member.name(), builder);
+
+                // Key members make the topic keyed, so that each instance can be told apart
+                if (member.is_key())
+                {
+                    result_ptr->apply_annotation_to_member(
+                        static_cast<MemberId>(idx), ANNOTATION_KEY_ID, "value", CONST_TRUE);
+                }
             }
             return result;
         }
@@ -2613,65 +2723,114 @@ void Conversion::get_array_specs(
     }
 }
 
-const xtypes::DynamicType& Conversion::resolve_discriminator_type(
-        const ::xtypes::DynamicType& service_type,
-        const std::string& discriminator)
+bool Conversion::compile_member_path(
+        const xtypes::DynamicType& type,
+        const std::string& path,
+        MemberPath& member_path)
 {
-    if (discriminator.find(".") == std::string::npos)
-    {
-        return service_type;
-    }
+    member_path.steps.clear();
+    member_path.type = &type;
+
+    // The first token names the type itself
+    std::string::size_type begin = path.find('.');
+    const xtypes::DynamicType* type_ptr = &resolve_type(type);
 
-    std::string path = discriminator;
-    const xtypes::DynamicType* type_ptr;
-    std::string type = path.substr(0, path.find("."));
-    std::string member;
-    type_ptr = &service_type;
-    while (path.find(".") != std::string::npos)
+    while (std::string::npos != begin)
     {
-        path = path.substr(path.find(".") + 1);
-        member = path.substr(0, path.find("."));
-        if (type_ptr->is_aggregation_type())
+        std::string::size_type end = path.find('.', begin + 1);
+        const std::string member = path.substr(begin + 1, std::string::npos == end ? end : end - begin - 1);
+        begin = end;
+
+        if (!type_ptr->is_aggregation_type())
         {
-            const xtypes::AggregationType& aggregation = static_cast<const xtypes::AggregationType&>(*type_ptr);
-            type_ptr = &aggregation.member(member).type();
+            logger_ << utils::Logger::Level::ERROR
+                    << "Cannot access member '" << member << "' of path '" << path
+                    << "', as type '" << type_ptr->name() << "' has no members" << std::endl;
+
+            return false;
         }
+
+        const xtypes::AggregationType& aggregation = static_cast<const xtypes::AggregationType&>(*type_ptr);
+        if (!aggregation.has_member(member))
+        {
+            logger_ << utils::Logger::Level::ERROR
+                    << "Type '" << aggregation.name() << "' of path '" << path
+                    << "' doesn't have a member named '" << member << "'" << std::endl;
+
+            return false;
+        }
+
+        MemberPath::Step step;
+        step.member_index = 0;
+        step.is_case = ::xtypes::TypeKind::UNION_TYPE == aggregation.kind();
+        for (uint32_t idx = 0; idx < aggregation.members().size(); ++idx)
+        {
+            if (aggregation.member(idx).name() == member)
+            {
+                step.member_index = idx;
+                break;
+            }
+        }
+        member_path.steps.push_back(step);
+
+        member_path.type = &aggregation.member(step.member_index).type();
+        type_ptr = &resolve_type(*member_path.type);
     }
 
-    return *type_ptr;
+    return true;
 }
 
 ::xtypes::WritableDynamicDataRef Conversion::access_member_data(
         ::xtypes::WritableDynamicDataRef membered_data,
-        const std::string& path)
+        const MemberPath& path)
 {
-    std::vector<std::string> nodes;
-    std::string token;
-    std::istringstream iss(path);
+    return access_member_data(membered_data, path, 0);
+}
 
-    // Split the path
-    while (std::getline(iss, token, '.'))
+::xtypes::WritableDynamicDataRef Conversion::access_member_data(
+        ::xtypes::WritableDynamicDataRef membered_data,
+        const MemberPath& path,
+        size_t index)
+{
+    if (index == path.steps.size())
     {
-        nodes.push_back(token);
+        return membered_data;
     }
 
-    // Navigate
-    return access_member_data(membered_data, nodes, 1);
+    const MemberPath::Step& step = path.steps[index];
+    if (step.is_case)
+    {
+        // Union cases are accessed by name, so that they get selected
+        const ::xtypes::AggregationType& aggregation =
+                static_cast<const ::xtypes::AggregationType&>(membered_data.type());
+        return access_member_data(membered_data[aggregation.member(step.member_index).name()], path, index + 1);
+    }
+
+    return access_member_data(membered_data[step.member_index], path, index + 1);
 }
 
-::xtypes::WritableDynamicDataRef Conversion::access_member_data(
-        ::xtypes::WritableDynamicDataRef membered_data,
-        const std::vector<std::string>& tokens,
+bool Conversion::is_member_selected(
+        ::xtypes::ReadableDynamicDataRef membered_data,
+        const MemberPath& path,
         size_t index)
 {
-    if (tokens.empty() || index == tokens.size())
+    if (index == path.steps.size())
     {
-        return membered_data;
+        return true;
     }
-    else
+
+    const MemberPath::Step& step = path.steps[index];
+    if (step.is_case)
     {
-        return access_member_data(membered_data[tokens[index]], tokens, index + 1);
+        const ::xtypes::AggregationType& aggregation =
+                static_cast<const ::xtypes::AggregationType&>(membered_data.type());
+        const std::string& member = aggregation.member(step.member_index).name();
+
+        return membered_data.current_case().name() == member
+               && is_member_selected(membered_data[member], path, index + 1);
     }
+
+    return is_member_selected(membered_data[step.member_index], path, index + 1);
 }
 
 } //  namespace fastdds
@@ -24,12 +24,14 @@
 #include <fastrtps/types/DynamicPubSubType.h>
 #include <fastrtps/types/DynamicData.h>
 
+#include "ConcurrentRegistry.hpp"
 #include "DDSMiddlewareException.hpp"
 
 #include <is/core/Message.hpp>
 #include <is/utils/Log.hpp>
 
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace fastdds = eprosima::fastdds;
@@ -58,50 +60,74 @@ public:
 
 };
 
-struct NavigationNode
+/**
+ * @brief Precompiled conversion plan for a structure type.
+ *
+ *        It stores, for each member of the structure, the information needed to convert it
+ *        between its *xtypes* and *Fast DDS* representations, so that no member name lookup
+ *        nor type resolution is performed for each converted message.
+ */
+struct ConversionPlan
 {
-    std::string member_name;
-    std::string type_name;
-    std::map<std::string, std::shared_ptr<NavigationNode> > member_node;
-    std::weak_ptr<NavigationNode> parent_node;
+    struct Step
+    {
+        /**
+         * Index of the member within the *xtypes* structure.
+         */
+        uint32_t member_index;
+
+        /**
+         * MemberId of the member within the *Fast DDS* structure.
+         */
+        MemberId id;
+
+        /**
+         * Resolved *xtypes* kind of the member.
+         */
+        ::xtypes::TypeKind kind;
+
+        /**
+         * Resolved *Fast DDS* kind of the member.
+         */
+        TypeKind dds_kind;
+
+        /**
+         * Plan of the member, only if it is a structure itself.
+         */
+        std::shared_ptr<const ConversionPlan> plan;
+    };
+
+    std::vector<Step> steps;
+};
 
-    std::string get_path();
+/**
+ * @brief Precompiled path to a member nested in a type, given in the configuration
+ *        with the `Type.member.submember` notation.
+ *
+ *        It stores the index of each member along the path, so that the member is reached
+ *        without parsing the path for each message. An empty path refers to the whole data.
+ */
+struct MemberPath
+{
+    struct Step
+    {
+        /**
+         * Index of the member within its *xtypes* aggregation type.
+         */
+        uint32_t member_index;
 
-    static std::string get_type(
-            std::map<std::string, std::shared_ptr<NavigationNode> > map_nodes,
-            const std::string& full_path);
+        /**
+         * Whether the member is a case of a union, which must be selected to access it.
+         */
+        bool is_case;
+    };
 
-    static std::shared_ptr<NavigationNode> fill_root_node(
-            std::shared_ptr<NavigationNode> root,
-            const ::xtypes::DynamicType& type,
-            const std::string& full_path);
+    std::vector<Step> steps;
 
     /**
-     * @brief get_discriminator Introspects data until it finds an active member of type contained in member_types.
-     *        This is useful for discriminate Union types in request/reply types.
+     * Type of the member at the end of the path.
      */
-    static std::shared_ptr<NavigationNode> get_discriminator(
-            const std::map<std::string, std::shared_ptr<NavigationNode> >& member_map,
-            const ::xtypes::DynamicData& data,
-            const std::vector<std::string>& member_types);
-
-private:
-
-    static std::string get_type(
-            std::shared_ptr<NavigationNode> root,
-            const std::string& full_path);
-
-    static void fill_member_node(
-            std::shared_ptr<NavigationNode> node,
-            const ::xtypes::DynamicType& type,
-            const std::string& full_path);
-
-    static std::shared_ptr<NavigationNode> get_discriminator(
-            std::shared_ptr<NavigationNode> node,
-            ::xtypes::ReadableDynamicDataRef data,
-            const std::vector<std::string>& member_types);
-
-    static utils::Logger logger_;
+    const ::xtypes::DynamicType* type = nullptr;
 };
 
 struct Conversion
@@ -127,24 +153,63 @@ struct Conversion
     static DynamicTypeBuilder* create_builder(
             const xtypes::DynamicType& type);
 
+    /**
+     * @brief Build and cache the conversion plan of a type, if it is a structure,
+     *        so that it is not built while converting the first message.
+     *        The same plan is used in both conversion directions.
+     */
+    static void prepare_plan(
+            const xtypes::DynamicType& type);
+
+    /**
+     * @brief Check whether a data instance of a type can be reused as the output of a new
+     *        conversion or deserialization without being reset first, that is, whether
+     *        the type contains no sequences nor maps, whose elements would be appended
+     *        to the ones left by the previous message.
+     */
+    static bool is_reusable(
+            const xtypes::DynamicType& type);
+
     // This function patches the problem of dynamic types, which do not admit '/' in their type name.
     static std::string convert_type_name(
             const std::string& message_type);
 
-    static const xtypes::DynamicType& resolve_discriminator_type(
-            const ::xtypes::DynamicType& service_type,
-            const std::string& discriminator);
+    /**
+     * @brief Compile a `Type.member.submember` path of a type into a MemberPath.
+     *        The first token of the path names the type itself.
+     *
+     * @returns `false` if the path does not lead to a member of the type.
+     */
+    static bool compile_member_path(
+            const xtypes::DynamicType& type,
+            const std::string& path,
+            MemberPath& member_path);
 
+    /**
+     * @brief Access the member of a data at the given path, selecting the union cases along it.
+     */
     static ::xtypes::WritableDynamicDataRef access_member_data(
             ::xtypes::WritableDynamicDataRef membered_data,
-            const std::string& path);
+            const MemberPath& path);
+
+    /**
+     * @brief Check whether the member at the given path holds the value of a data,
+     *        that is, whether every union along the path has selected the case of the path.
+     */
+    static bool is_member_selected(
+            ::xtypes::ReadableDynamicDataRef membered_data,
+            const MemberPath& path,
+            size_t index = 0);
 
 private:
 
     ~Conversion() = default;
-    static std::map<std::string, ::xtypes::DynamicType::Ptr> types_;
-    static std::map<std::string, DynamicPubSubType*> registered_types_;
-    static std::map<std::string, DynamicTypeBuilder_ptr> builders_;
+
+    // Registries keyed by type name, which may be used concurrently by publishers and subscribers
+    static ConcurrentRegistry<::xtypes::DynamicType::Ptr> types_;
+    static ConcurrentRegistry<DynamicPubSubType*> registered_types_;
+    static ConcurrentRegistry<DynamicTypeBuilder_ptr> builders_;
+    static ConcurrentRegistry<std::shared_ptr<const ConversionPlan> > plans_;
 
     static const xtypes::DynamicType& resolve_type(
             const xtypes::DynamicType& type);
@@ -159,12 +224,27 @@ private:
             const xtypes::ArrayType& array,
             std::pair<std::vector<uint32_t>, DynamicTypeBuilder_ptr>& result);
 
+    static std::shared_ptr<const ConversionPlan> get_plan(
+            const ::xtypes::StructType& type);
+
+    static std::shared_ptr<const ConversionPlan> build_plan(
+            const ::xtypes::StructType& type);
+
     // xtypes Dynamic Data -> FastDDS Dynamic Data
     static void set_primitive_data(
             xtypes::ReadableDynamicDataRef from,
             DynamicData* to,
             eprosima::fastrtps::types::MemberId id);
 
+    // xtypes Dynamic Data -> FastDDS Dynamic Data, for sequences and arrays of primitive types.
+    // Returns false if the elements kind is not eligible for the bulk conversion.
+    static bool set_primitive_collection_data(
+            ::xtypes::ReadableDynamicDataRef from,
+            DynamicData* to,
+            ::xtypes::TypeKind kind,
+            bool is_sequence,
+            MemberId first_id);
+
     // xtypes Dynamic Data -> FastDDS Dynamic Data
     static void set_sequence_data(
             ::xtypes::ReadableDynamicDataRef from,
@@ -186,11 +266,26 @@ private:
             ::xtypes::ReadableDynamicDataRef input,
             DynamicData* output);
 
+    // xtypes Dynamic Data -> FastDDS Dynamic Data
+    static bool set_struct_data(
+            ::xtypes::ReadableDynamicDataRef input,
+            DynamicData* output,
+            const ConversionPlan& plan);
+
     // xtypes Dynamic Data -> FastDDS Dynamic Data
     static bool set_union_data(
             ::xtypes::ReadableDynamicDataRef input,
             DynamicData* output);
 
+    // FastDDS Dynamic Data -> xtypes Dynamic Data, for sequences and arrays of primitive types.
+    // Returns false if the elements kind is not eligible for the bulk conversion.
+    static bool set_primitive_collection_data(
+            const DynamicData* from,
+            ::xtypes::WritableDynamicDataRef to,
+            ::xtypes::TypeKind kind,
+            MemberId first_id,
+            uint32_t count);
+
     // FastDDS Dynamic Data -> xtypes Dynamic Data
     static void set_sequence_data(
             const DynamicData* from,
@@ -212,6 +307,12 @@ private:
             const DynamicData* input,
             ::xtypes::WritableDynamicDataRef output);
 
+    // FastDDS Dynamic Data -> xtypes Dynamic Data
+    static bool set_struct_data(
+            const DynamicData* input,
+            ::xtypes::WritableDynamicDataRef output,
+            const ConversionPlan& plan);
+
     // FastDDS Dynamic Data -> xtypes Dynamic Data
     static bool set_union_data(
             const DynamicData* input,
@@ -219,7 +320,7 @@ private:
 
     static ::xtypes::WritableDynamicDataRef access_member_data(
             ::xtypes::WritableDynamicDataRef membered_data,
-            const std::vector<std::string>& tokens,
+            const MemberPath& path,
             size_t index);
 
     static utils::Logger logger_;
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_FASTDDS__INTERNAL__LOGSAMPLER_HPP_
+#define _IS_SH_FASTDDS__INTERNAL__LOGSAMPLER_HPP_
+
+#include <is/utils/Log.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+/**
+ * @class LogSampler
+ *        Decides whether the contents of a message must be logged, before they are formatted.
+ *
+ *        Messages are only printed if the logger level allows it, and then only one out
+ *        of every `one_in` messages, so that printing large messages does not slow down
+ *        a busy topic.
+ */
+class LogSampler
+{
+public:
+
+    /**
+     * @brief By default, every message is logged.
+     */
+    static constexpr uint32_t DEFAULT_ONE_IN = 1;
+
+    /**
+     * @brief Construct a new LogSampler object.
+     *
+     * @param[in] one_in Log one out of every `one_in` messages.
+     */
+    explicit LogSampler(
+            uint32_t one_in = DEFAULT_ONE_IN)
+        : one_in_(one_in)
+        , counter_(0)
+    {
+    }
+
+    /**
+     * @brief Change the sampling rate.
+     *
+     * @param[in] one_in Log one out of every `one_in` messages.
+     */
+    void one_in(
+            uint32_t one_in)
+    {
+        one_in_ = one_in;
+    }
+
+    /**
+     * @brief Check whether the current message must be logged. Each call, while the level
+     *        is enabled, counts as a new message for the sampling.
+     *
+     * @param[in] logger The logger the message would be written to.
+     *
+     * @param[in] level The level of the message.
+     *
+     * @returns `true` if the message must be formatted and logged.
+     */
+    bool enabled(
+            utils::Logger& logger,
+            utils::Logger::Level level)
+    {
+        if (logger.get_level() > level)
+        {
+            return false;
+        }
+
+        return one_in_ <= 1 || 0 == counter_.fetch_add(1, std::memory_order_relaxed) % one_in_;
+    }
+
+private:
+
+    /**
+     * Class members.
+     */
+    uint32_t one_in_;
+    std::atomic<uint64_t> counter_;
+};
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_FASTDDS__INTERNAL__LOGSAMPLER_HPP_
@@ -0,0 +1,351 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "Metrics.hpp"
+#include "DDSMiddlewareException.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+constexpr uint32_t LatencyHistogram::SUB_BUCKET_BITS;
+constexpr uint32_t LatencyHistogram::SUB_BUCKETS;
+constexpr uint32_t LatencyHistogram::BUCKETS;
+constexpr uint32_t MetricsReporter::DEFAULT_PERIOD_MS;
+
+namespace {
+
+/**
+ * @brief Position of the most significant bit set in a non-zero value.
+ */
+uint32_t most_significant_bit(
+        uint64_t value)
+{
+    uint32_t msb = 0;
+    for (uint32_t shift = 32; shift > 0; shift /= 2)
+    {
+        if (value >> shift)
+        {
+            value >>= shift;
+            msb += shift;
+        }
+    }
+    return msb;
+}
+
+void write_histogram(
+        const LatencyHistogram::Snapshot& histogram,
+        YAML::Emitter& out)
+{
+    out << YAML::BeginMap;
+    out << YAML::Key << "count" << YAML::Value << histogram.count;
+    out << YAML::Key << "mean_ns" << YAML::Value << histogram.mean_ns;
+    out << YAML::Key << "p50_ns" << YAML::Value << histogram.p50_ns;
+    out << YAML::Key << "p90_ns" << YAML::Value << histogram.p90_ns;
+    out << YAML::Key << "p99_ns" << YAML::Value << histogram.p99_ns;
+    out << YAML::Key << "p999_ns" << YAML::Value << histogram.p999_ns;
+    out << YAML::Key << "max_ns" << YAML::Value << histogram.max_ns;
+    out << YAML::EndMap;
+}
+
+} //  anonymous namespace
+
+LatencyHistogram::LatencyHistogram()
+    : sum_ns_(0)
+    , max_ns_(0)
+{
+    for (std::atomic<uint64_t>& bucket : buckets_)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::record(
+        std::chrono::nanoseconds duration)
+{
+    const uint64_t value = duration.count() > 0 ? static_cast<uint64_t>(duration.count()) : 0;
+
+    buckets_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    sum_ns_.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t max = max_ns_.load(std::memory_order_relaxed);
+    while (value > max && !max_ns_.compare_exchange_weak(max, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const
+{
+    Snapshot result;
+
+    std::array<uint64_t, BUCKETS> buckets;
+    for (uint32_t i = 0; i < BUCKETS; ++i)
+    {
+        buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        result.count += buckets[i];
+    }
+
+    if (0 == result.count)
+    {
+        return result;
+    }
+
+    result.mean_ns = sum_ns_.load(std::memory_order_relaxed) / result.count;
+    result.max_ns = max_ns_.load(std::memory_order_relaxed);
+
+    // Each percentile is reported as the upper bound of the bucket where it falls
+    const std::pair<double, uint64_t*> percentiles[] = {
+        {0.5, &result.p50_ns},
+        {0.9, &result.p90_ns},
+        {0.99, &result.p99_ns},
+        {0.999, &result.p999_ns}
+    };
+
+    uint64_t accumulated = 0;
+    uint32_t index = 0;
+    for (const auto& percentile : percentiles)
+    {
+        // Nearest rank: the smallest value greater than or equal to that percentage of the values
+        const uint64_t target = std::max<uint64_t>(
+            1, static_cast<uint64_t>(std::ceil(percentile.first * static_cast<double>(result.count))));
+        while (accumulated + buckets[index] < target)
+        {
+            accumulated += buckets[index++];
+        }
+        *percentile.second = std::min(bucket_upper_bound(index), result.max_ns);
+    }
+
+    return result;
+}
+
+uint32_t LatencyHistogram::bucket_index(
+        uint64_t value)
+{
+    if (value < SUB_BUCKETS)
+    {
+        return static_cast<uint32_t>(value);
+    }
+
+    const uint32_t shift = most_significant_bit(value) - SUB_BUCKET_BITS;
+    const uint32_t sub_bucket = static_cast<uint32_t>(value >> shift) & (SUB_BUCKETS - 1);
+    return SUB_BUCKETS + shift * SUB_BUCKETS + sub_bucket;
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(
+        uint32_t index)
+{
+    if (index < SUB_BUCKETS)
+    {
+        return index;
+    }
+
+    const uint32_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+    const uint64_t sub_bucket = SUB_BUCKETS + (index - SUB_BUCKETS) % SUB_BUCKETS;
+    const uint64_t lower_bound = sub_bucket << shift;
+    return lower_bound + ((uint64_t(1) << shift) - 1);
+}
+
+std::shared_ptr<TopicMetrics> Metrics::topic(
+        const std::string& entity,
+        const std::string& topic)
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+
+    std::shared_ptr<TopicMetrics>& metrics = topics_[std::make_pair(entity, topic)];
+    if (!metrics)
+    {
+        metrics = std::make_shared<TopicMetrics>();
+    }
+    return metrics;
+}
+
+std::vector<TopicMetrics::Snapshot> Metrics::snapshot() const
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+
+    std::vector<TopicMetrics::Snapshot> result;
+    result.reserve(topics_.size());
+    for (const auto& topic : topics_)
+    {
+        const TopicMetrics& metrics = *topic.second;
+
+        TopicMetrics::Snapshot snapshot;
+        snapshot.entity = topic.first.first;
+        snapshot.topic = topic.first.second;
+        snapshot.samples_in = metrics.samples_in.load(std::memory_order_relaxed);
+        snapshot.samples_out = metrics.samples_out.load(std::memory_order_relaxed);
+        snapshot.dropped = metrics.dropped.load(std::memory_order_relaxed);
+        snapshot.queue_depth = metrics.queue_depth.load(std::memory_order_relaxed);
+        snapshot.conversion = metrics.conversion.snapshot();
+        snapshot.delivery = metrics.delivery.snapshot();
+        result.emplace_back(std::move(snapshot));
+    }
+
+    return result;
+}
+
+MetricsReporter::MetricsReporter(
+        const Metrics& metrics,
+        const YAML::Node& config)
+    : metrics_(metrics)
+    , period_(DEFAULT_PERIOD_MS)
+    , last_dump_(std::chrono::steady_clock::now())
+    , logger_("is::sh::FastDDS::Metrics")
+{
+    try
+    {
+        if (config["file"])
+        {
+            file_ = config["file"].as<std::string>();
+        }
+
+        if (config["period_ms"])
+        {
+            period_ = std::chrono::milliseconds(config["period_ms"].as<uint32_t>());
+        }
+    }
+    catch (const YAML::Exception& e)
+    {
+        std::ostringstream err;
+        err << "Invalid metrics configuration: " << e.what();
+
+        throw DDSMiddlewareException(logger_, err.str());
+    }
+
+    if (file_.empty())
+    {
+        throw DDSMiddlewareException(logger_, "Invalid metrics configuration: 'file' is mandatory");
+    }
+
+    if (0 == period_.count())
+    {
+        throw DDSMiddlewareException(
+                  logger_, "Invalid metrics configuration: 'period_ms' must be greater than zero");
+    }
+
+    logger_ << utils::Logger::Level::INFO
+            << "Dumping metrics to '" << file_ << "' every " << period_.count() << " ms" << std::endl;
+}
+
+void MetricsReporter::update()
+{
+    if (std::chrono::steady_clock::now() - last_dump_ >= period_)
+    {
+        dump();
+    }
+}
+
+bool MetricsReporter::dump()
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::vector<TopicMetrics::Snapshot> snapshots = metrics_.snapshot();
+
+    // Written aside and then renamed, so that readers never see a partial document
+    const std::string tmp_file = file_ + ".tmp";
+    {
+        std::ofstream out(tmp_file, std::ios::trunc);
+        if (out)
+        {
+            write(snapshots, previous_, now - last_dump_, out);
+        }
+
+        if (!out)
+        {
+            logger_ << utils::Logger::Level::WARN
+                    << "Failed to write metrics to '" << tmp_file << "'" << std::endl;
+            return false;
+        }
+    }
+
+    if (0 != std::rename(tmp_file.c_str(), file_.c_str()))
+    {
+        logger_ << utils::Logger::Level::WARN
+                << "Failed to replace metrics file '" << file_ << "'" << std::endl;
+        return false;
+    }
+
+    last_dump_ = now;
+    previous_ = std::move(snapshots);
+    return true;
+}
+
+void MetricsReporter::write(
+        const std::vector<TopicMetrics::Snapshot>& snapshots,
+        const std::vector<TopicMetrics::Snapshot>& previous,
+        std::chrono::steady_clock::duration elapsed,
+        std::ostream& out)
+{
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+
+    YAML::Emitter emitter;
+    emitter << YAML::BeginMap;
+    emitter << YAML::Key << "period_s" << YAML::Value << seconds;
+    emitter << YAML::Key << "topics" << YAML::Value << YAML::BeginSeq;
+
+    for (const TopicMetrics::Snapshot& snapshot : snapshots)
+    {
+        // Topics created after the previous dump count from zero
+        uint64_t previous_in = 0;
+        uint64_t previous_out = 0;
+        for (const TopicMetrics::Snapshot& old : previous)
+        {
+            if (old.entity == snapshot.entity && old.topic == snapshot.topic)
+            {
+                previous_in = old.samples_in;
+                previous_out = old.samples_out;
+                break;
+            }
+        }
+
+        emitter << YAML::BeginMap;
+        emitter << YAML::Key << "topic" << YAML::Value << snapshot.topic;
+        emitter << YAML::Key << "entity" << YAML::Value << snapshot.entity;
+        emitter << YAML::Key << "samples_in" << YAML::Value << snapshot.samples_in;
+        emitter << YAML::Key << "samples_out" << YAML::Value << snapshot.samples_out;
+        emitter << YAML::Key << "dropped" << YAML::Value << snapshot.dropped;
+        emitter << YAML::Key << "queue_depth" << YAML::Value << snapshot.queue_depth;
+        if (seconds > 0)
+        {
+            emitter << YAML::Key << "rate_in" << YAML::Value
+                    << static_cast<double>(snapshot.samples_in - previous_in) / seconds;
+            emitter << YAML::Key << "rate_out" << YAML::Value
+                    << static_cast<double>(snapshot.samples_out - previous_out) / seconds;
+        }
+        emitter << YAML::Key << "conversion" << YAML::Value;
+        write_histogram(snapshot.conversion, emitter);
+        emitter << YAML::Key << "delivery" << YAML::Value;
+        write_histogram(snapshot.delivery, emitter);
+        emitter << YAML::EndMap;
+    }
+
+    emitter << YAML::EndSeq;
+    emitter << YAML::EndMap;
+
+    out << emitter.c_str() << std::endl;
+}
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
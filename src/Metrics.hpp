@@ -0,0 +1,261 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_FASTDDS__INTERNAL__METRICS_HPP_
+#define _IS_SH_FASTDDS__INTERNAL__METRICS_HPP_
+
+#include <is/utils/Log.hpp>
+
+#include <yaml-cpp/yaml.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+/**
+ * @class LatencyHistogram
+ *        Histogram of durations, in nanoseconds, with logarithmic buckets split into linear
+ *        sub-buckets, as HDR histograms do. Any value can be recorded, with a relative error
+ *        below 12.5%, in a fixed amount of memory.
+ *
+ *        Values are recorded with relaxed atomic operations, so several threads can record
+ *        into the same histogram without locking.
+ */
+class LatencyHistogram
+{
+public:
+
+    /**
+     * @brief Summary of the recorded values.
+     */
+    struct Snapshot
+    {
+        uint64_t count = 0;
+        uint64_t mean_ns = 0;
+        uint64_t max_ns = 0;
+        uint64_t p50_ns = 0;
+        uint64_t p90_ns = 0;
+        uint64_t p99_ns = 0;
+        uint64_t p999_ns = 0;
+    };
+
+    /**
+     * @brief Construct a new, empty, LatencyHistogram object.
+     */
+    LatencyHistogram();
+
+    /**
+     * @brief Record a new value.
+     *
+     * @param[in] duration The value to record.
+     */
+    void record(
+            std::chrono::nanoseconds duration);
+
+    /**
+     * @brief Summarize the values recorded so far.
+     */
+    Snapshot snapshot() const;
+
+private:
+
+    /**
+     * Number of linear sub-buckets per power of two, as a power of two itself.
+     */
+    static constexpr uint32_t SUB_BUCKET_BITS = 3;
+    static constexpr uint32_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static constexpr uint32_t BUCKETS = SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+    static uint32_t bucket_index(
+            uint64_t value);
+
+    static uint64_t bucket_upper_bound(
+            uint32_t index);
+
+    /**
+     * Class members.
+     */
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets_;
+    std::atomic<uint64_t> sum_ns_;
+    std::atomic<uint64_t> max_ns_;
+};
+
+/**
+ * @brief Statistics of a DDS entity routing a topic, filled in by the entity itself.
+ *
+ *        For publishers, samples go in from the *Integration Service* and out to DDS;
+ *        for subscribers, they go in from DDS and out to the *Integration Service*.
+ *        The conversion time is the time spent converting a message between its *xtypes* and
+ *        *Fast DDS* representations; the delivery time is the time spent handing it over
+ *        to its destination, that is, writing it to DDS or running the *Integration Service* callback.
+ */
+struct TopicMetrics
+{
+    /**
+     * @brief Copy of the metrics of a topic at a given time.
+     */
+    struct Snapshot
+    {
+        std::string entity;
+        std::string topic;
+        uint64_t samples_in = 0;
+        uint64_t samples_out = 0;
+        uint64_t dropped = 0;
+        uint64_t queue_depth = 0;
+        LatencyHistogram::Snapshot conversion;
+        LatencyHistogram::Snapshot delivery;
+    };
+
+    std::atomic<uint64_t> samples_in{0};
+    std::atomic<uint64_t> samples_out{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> queue_depth{0};
+    LatencyHistogram conversion;
+    LatencyHistogram delivery;
+};
+
+/**
+ * @class Metrics
+ *        Registry of the TopicMetrics of all the DDS entities created by the *Fast DDS System Handle*.
+ */
+class Metrics
+{
+public:
+
+    /**
+     * @brief Construct a new, empty, Metrics object.
+     */
+    Metrics() = default;
+
+    /**
+     * @brief Get the metrics of an entity kind and topic, creating them if needed.
+     *
+     * @param[in] entity The kind of entity, e.g. `publisher` or `subscriber`.
+     *
+     * @param[in] topic The topic name.
+     *
+     * @returns The metrics, shared by all the entities of the same kind and topic.
+     */
+    std::shared_ptr<TopicMetrics> topic(
+            const std::string& entity,
+            const std::string& topic);
+
+    /**
+     * @brief Copy the current metrics of every registered topic.
+     */
+    std::vector<TopicMetrics::Snapshot> snapshot() const;
+
+private:
+
+    /**
+     * Class members.
+     */
+    std::map<std::pair<std::string, std::string>, std::shared_ptr<TopicMetrics> > topics_;
+    mutable std::mutex mtx_;
+};
+
+/**
+ * @class MetricsReporter
+ *        Periodically dumps the metrics to a local file, as a YAML document which is replaced
+ *        on each dump. Besides the accumulated values, it reports the sample rates since the previous dump.
+ */
+class MetricsReporter
+{
+public:
+
+    /**
+     * @brief Default dump period, in milliseconds.
+     */
+    static constexpr uint32_t DEFAULT_PERIOD_MS = 1000;
+
+    /**
+     * @brief Construct a new MetricsReporter object.
+     *
+     * @param[in] metrics The metrics to dump.
+     *
+     * @param[in] config The `metrics` configuration node. Allowed fields are:
+     *            - `file`: Path of the file to write. Mandatory.
+     *            - `period_ms`: Time between dumps. Defaults to DEFAULT_PERIOD_MS.
+     *
+     * @throws DDSMiddlewareException if the configuration is not valid.
+     */
+    MetricsReporter(
+            const Metrics& metrics,
+            const YAML::Node& config);
+
+    /**
+     * @brief Dump the metrics if the period has elapsed since the previous dump.
+     *        Meant to be called periodically, e.g. each time the System Handle spins.
+     */
+    void update();
+
+    /**
+     * @brief Write the metrics to the configured file.
+     *
+     * @returns `false` if the file could not be written.
+     */
+    bool dump();
+
+    /**
+     * @brief Write a set of metrics as a YAML document.
+     *
+     * @param[in] snapshots The metrics to write.
+     *
+     * @param[in] previous The metrics of the previous dump, used to compute the sample rates.
+     *
+     * @param[in] elapsed Time elapsed since the previous dump.
+     *
+     * @param[out] out The stream to write to.
+     */
+    static void write(
+            const std::vector<TopicMetrics::Snapshot>& snapshots,
+            const std::vector<TopicMetrics::Snapshot>& previous,
+            std::chrono::steady_clock::duration elapsed,
+            std::ostream& out);
+
+private:
+
+    /**
+     * Class members.
+     */
+    const Metrics& metrics_;
+    std::string file_;
+    std::chrono::milliseconds period_;
+    std::chrono::steady_clock::time_point last_dump_;
+    std::vector<TopicMetrics::Snapshot> previous_;
+
+    utils::Logger logger_;
+};
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_FASTDDS__INTERNAL__METRICS_HPP_
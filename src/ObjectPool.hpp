@@ -0,0 +1,168 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_FASTDDS__INTERNAL__OBJECTPOOL_HPP_
+#define _IS_SH_FASTDDS__INTERNAL__OBJECTPOOL_HPP_
+
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+/**
+ * @class ObjectPool
+ *        Keeps a set of idle objects, so that they can be reused by several threads
+ *        instead of being created and destroyed for each use.
+ *
+ *        The lock is only held to take or return an object; the objects themselves are used
+ *        without any synchronization, since each of them belongs to a single thread at a time.
+ *
+ * @tparam T The type of the pooled objects.
+ */
+template<typename T>
+class ObjectPool
+{
+public:
+
+    /**
+     * @brief Signature of the function creating a new object.
+     */
+    using Factory = std::function<T* ()>;
+
+    /**
+     * @brief Signature of the function destroying an object.
+     */
+    using Deleter = std::function<void (T*)>;
+
+    /**
+     * @brief Construct a new ObjectPool object.
+     *
+     * @param[in] factory Function used to create new objects, when no idle one is available.
+     *
+     * @param[in] deleter Function used to destroy the objects.
+     *
+     * @param[in] max_idle Maximum number of idle objects kept by the pool.
+     */
+    ObjectPool(
+            Factory factory,
+            Deleter deleter,
+            std::size_t max_idle)
+        : factory_(std::move(factory))
+        , deleter_(std::move(deleter))
+        , max_idle_(max_idle)
+    {
+    }
+
+    /**
+     * @brief Destroy the ObjectPool object, along with its idle objects.
+     */
+    ~ObjectPool()
+    {
+        for (T* object : idle_)
+        {
+            deleter_(object);
+        }
+    }
+
+    /**
+     * @brief ObjectPool shall not be copy constructible.
+     */
+    ObjectPool(
+            const ObjectPool& /*rhs*/) = delete;
+
+    /**
+     * @brief ObjectPool shall not be copy assignable.
+     */
+    ObjectPool& operator = (
+            const ObjectPool& /*rhs*/) = delete;
+
+    /**
+     * @brief ObjectPool shall not be move constructible.
+     */
+    ObjectPool(
+            ObjectPool&& /*rhs*/) = delete;
+
+    /**
+     * @brief ObjectPool shall not be move assignable.
+     */
+    ObjectPool& operator = (
+            ObjectPool&& /*rhs*/) = delete;
+
+    /**
+     * @brief Take an idle object from the pool, or create a new one if there is none.
+     *
+     * @returns The object, owned by the caller until it is released.
+     */
+    T* acquire()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            if (!idle_.empty())
+            {
+                T* object = idle_.back();
+                idle_.pop_back();
+                return object;
+            }
+        }
+
+        return factory_();
+    }
+
+    /**
+     * @brief Give an object back to the pool. It is destroyed if the pool is already full.
+     *
+     * @param[in] object The object to release.
+     */
+    void release(
+            T* object)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            if (idle_.size() < max_idle_)
+            {
+                idle_.push_back(object);
+                return;
+            }
+        }
+
+        deleter_(object);
+    }
+
+private:
+
+    /**
+     * Class members.
+     */
+    Factory factory_;
+    Deleter deleter_;
+    const std::size_t max_idle_;
+
+    std::vector<T*> idle_;
+    std::mutex mtx_;
+};
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_FASTDDS__INTERNAL__OBJECTPOOL_HPP_
@@ -18,8 +18,14 @@
 #include "Participant.hpp"
 #include "DDSMiddlewareException.hpp"
 #include "Conversion.hpp"
+#include "XTypesPubSubType.hpp"
 
+#include <fastdds/rtps/attributes/PropertyPolicy.h>
 #include <fastdds/rtps/transport/UDPv4TransportDescriptor.h>
+#include <fastdds/rtps/transport/shared_mem/SharedMemTransportDescriptor.h>
+#if FASTRTPS_VERSION_MINOR >= 4
+#include <fastdds/rtps/flowcontrol/FlowControllerDescriptor.hpp>
+#endif //  if FASTRTPS_VERSION_MINOR >= 4
 
 #include <fastrtps/types/DynamicDataFactory.h>
 #include <fastrtps/xmlparser/XMLProfileManager.h>
@@ -31,8 +37,22 @@ namespace is {
 namespace sh {
 namespace fastdds {
 
+static void set_ignore_local_endpoints(
+        ::fastdds::dds::DomainParticipantQos& qos)
+{
+    // Honored since Fast DDS 2.10, previous versions just ignore it
+    const std::string property_name("fastdds.ignore_local_endpoints");
+
+    if (nullptr == fastrtps::rtps::PropertyPolicyHelper::find_property(qos.properties(), property_name))
+    {
+        qos.properties().properties().emplace_back(property_name, "true");
+    }
+}
+
 Participant::Participant()
     : dds_participant_(nullptr)
+    , ignore_local_endpoints_(true)
+    , pending_events_(0)
     , logger_("is::sh::FastDDS::Participant")
 {
     build_participant();
@@ -41,11 +61,39 @@ Participant::Participant()
 Participant::Participant(
         const YAML::Node& config)
     : dds_participant_(nullptr)
+    , ignore_local_endpoints_(true)
+    , pending_events_(0)
     , logger_("is::sh::FastDDS::Participant")
 {
     using fastrtps::xmlparser::XMLP_ret;
     using fastrtps::xmlparser::XMLProfileManager;
 
+    if (config.IsMap() && config["ignore_local_endpoints"])
+    {
+        try
+        {
+            ignore_local_endpoints_ = config["ignore_local_endpoints"].as<bool>();
+        }
+        catch (const YAML::Exception& e)
+        {
+            std::ostringstream err;
+            err << "Invalid 'ignore_local_endpoints' configuration for the Fast DDS participant: "
+                << e.what();
+
+            throw DDSMiddlewareException(logger_, err.str());
+        }
+    }
+
+    if (config.IsMap() && config["transport"])
+    {
+        parse_transport(config["transport"]);
+    }
+
+    if (config.IsMap() && config["flow_controllers"])
+    {
+        parse_flow_controllers(config["flow_controllers"]);
+    }
+
     if (!config.IsMap() || !config["file_path"] || !config["profile_name"])
     {
         if (config["domain_id"])
@@ -53,6 +101,10 @@ Participant::Participant(
             const ::fastdds::dds::DomainId_t domain_id = config["domain_id"].as<uint32_t>();
             build_participant(domain_id);
         }
+        else if (transport_.configured || !flow_controllers_.empty())
+        {
+            build_participant();
+        }
         else
         {
             std::ostringstream err;
@@ -114,11 +166,13 @@ void Participant::build_participant(
     ::fastdds::dds::DomainParticipantQos participant_qos = ::fastdds::dds::PARTICIPANT_QOS_DEFAULT;
     participant_qos.name("default_IS-FastDDS-SH_participant");
 
-    // By default use UDPv4 due to communication failures between dockers sharing the network with the host
-    // When it is solved in Fast-DDS delete the following lines and use the default builtin transport.
-    participant_qos.transport().use_builtin_transports = false;
-    auto udp_transport = std::make_shared<::fastdds::rtps::UDPv4TransportDescriptor>();
-    participant_qos.transport().user_transports.push_back(udp_transport);
+    configure_transports(participant_qos);
+    configure_flow_controllers(participant_qos);
+
+    if (ignore_local_endpoints_)
+    {
+        set_ignore_local_endpoints(participant_qos);
+    }
 
     dds_participant_ = ::fastdds::dds::DomainParticipantFactory::get_instance()->create_participant(
         domain_id, participant_qos);
@@ -153,9 +207,26 @@ void Participant::register_dynamic_type(
     auto topic_to_type_it = topic_to_type_.find(topic_name);
     if (topic_to_type_it != topic_to_type_.end())
     {
+        if (xtypes_types_.end() != xtypes_types_.find(topic_to_type_it->second))
+        {
+            std::ostringstream err;
+            err << "Topic '" << topic_name << "' was already registered with direct serialization";
+
+            throw DDSMiddlewareException(logger_, err.str());
+        }
+
         return; // Already registered.
     }
 
+    if (xtypes_types_.end() != xtypes_types_.find(type_name))
+    {
+        std::ostringstream err;
+        err << "Dynamic type '" << type_name << "' for topic '" << topic_name
+            << "' was already registered with direct serialization";
+
+        throw DDSMiddlewareException(logger_, err.str());
+    }
+
     auto types_it = types_.find(type_name);
     if (types_.end() != types_it)
     {
@@ -234,6 +305,87 @@ void Participant::register_dynamic_type(
     }
 }
 
+void Participant::register_xtypes_type(
+        const std::string& topic_name,
+        const xtypes::DynamicType& type,
+        fastrtps::types::DynamicTypeBuilder* builder)
+{
+    const std::string& type_name = type.name();
+
+    auto topic_to_type_it = topic_to_type_.find(topic_name);
+    if (topic_to_type_it != topic_to_type_.end())
+    {
+        if (xtypes_types_.end() == xtypes_types_.find(topic_to_type_it->second))
+        {
+            std::ostringstream err;
+            err << "Topic '" << topic_name << "' was already registered without direct serialization";
+
+            throw DDSMiddlewareException(logger_, err.str());
+        }
+
+        return; // Already registered.
+    }
+
+    if (types_.end() != types_.find(type_name))
+    {
+        std::ostringstream err;
+        err << "Type '" << type_name << "' for topic '" << topic_name
+            << "' was already registered without direct serialization";
+
+        throw DDSMiddlewareException(logger_, err.str());
+    }
+
+    if (xtypes_types_.end() == xtypes_types_.find(type_name))
+    {
+        fastrtps::types::DynamicType_ptr dtptr = builder->build();
+        if (dtptr == nullptr)
+        {
+            std::ostringstream err;
+            err << "Dynamic type '" << type_name << "' for topic '"
+                << topic_name << "' was not correctly built";
+
+            throw DDSMiddlewareException(logger_, err.str());
+        }
+
+        ::fastdds::dds::TypeSupport type_support(new XTypesPubSubType(type, dtptr));
+
+        // Register it within the DomainParticipant
+        if (!dds_participant_->register_type(type_support))
+        {
+            std::ostringstream err;
+            err << "Type '" << type_name << "' registration with direct serialization failed";
+
+            throw DDSMiddlewareException(logger_, err.str());
+        }
+
+        xtypes_types_.emplace(type_name, type_support);
+
+        logger_ << utils::Logger::Level::DEBUG
+                << "Registered type '" << type_name << "' with direct serialization in topic '"
+                << topic_name << "'" << std::endl;
+    }
+
+    topic_to_type_.emplace(topic_name, type_name);
+}
+
+XTypesPubSubType* Participant::get_xtypes_type(
+        const std::string& topic_name) const
+{
+    auto topic_to_type_it = topic_to_type_.find(topic_name);
+    if (topic_to_type_.end() == topic_to_type_it)
+    {
+        return nullptr;
+    }
+
+    auto xtypes_type_it = xtypes_types_.find(topic_to_type_it->second);
+    if (xtypes_types_.end() == xtypes_type_it)
+    {
+        return nullptr;
+    }
+
+    return static_cast<XTypesPubSubType*>(xtypes_type_it->second.get());
+}
+
 fastrtps::types::DynamicData* Participant::create_dynamic_data(
         const std::string& topic_name) const
 {
@@ -251,7 +403,7 @@ fastrtps::types::DynamicData* Participant::create_dynamic_data(
     if (types_.end() == types_it)
     {
         std::ostringstream err;
-        err << "Creating dynamic data: dynamic type '" << types_it->first << "' not defined";
+        err << "Creating dynamic data: dynamic type '" << topic_to_type_it->second << "' not defined";
 
         throw DDSMiddlewareException(logger_, err.str());
     }
@@ -322,6 +474,282 @@ bool Participant::dissociate_topic_from_dds_entity(
     }
 }
 
+void Participant::notify_event()
+{
+    {
+        std::unique_lock<std::mutex> lock(event_mtx_);
+        ++pending_events_;
+    }
+
+    event_cv_.notify_all();
+}
+
+bool Participant::wait_for_event(
+        std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(event_mtx_);
+
+    bool notified = event_cv_.wait_for(
+        lock,
+        timeout,
+        [this]()
+        {
+            return 0 < pending_events_;
+        });
+
+    pending_events_ = 0;
+    return notified;
+}
+
+Metrics& Participant::metrics()
+{
+    return metrics_;
+}
+
+void Participant::configure_data_sharing(
+        ::fastdds::dds::DataWriterQos& qos,
+        const ::fastdds::dds::Topic* topic) const
+{
+#if FASTRTPS_VERSION_MINOR >= 2
+    if (transport_.data_sharing)
+    {
+        if (!*transport_.data_sharing)
+        {
+            qos.data_sharing().off();
+        }
+        else if (is_bounded_type(topic))
+        {
+            qos.data_sharing().on(transport_.data_sharing_directory);
+        }
+        else
+        {
+            // Forcing it would make the creation of the entities of unbounded types fail
+            qos.data_sharing().automatic(transport_.data_sharing_directory);
+        }
+    }
+#else
+    (void)qos;
+    (void)topic;
+#endif //  if FASTRTPS_VERSION_MINOR >= 2
+}
+
+void Participant::configure_data_sharing(
+        ::fastdds::dds::DataReaderQos& qos,
+        const ::fastdds::dds::Topic* topic) const
+{
+#if FASTRTPS_VERSION_MINOR >= 2
+    if (transport_.data_sharing)
+    {
+        if (!*transport_.data_sharing)
+        {
+            qos.data_sharing().off();
+        }
+        else if (is_bounded_type(topic))
+        {
+            qos.data_sharing().on(transport_.data_sharing_directory);
+        }
+        else
+        {
+            // Forcing it would make the creation of the entities of unbounded types fail
+            qos.data_sharing().automatic(transport_.data_sharing_directory);
+        }
+    }
+#else
+    (void)qos;
+    (void)topic;
+#endif //  if FASTRTPS_VERSION_MINOR >= 2
+}
+
+bool Participant::is_bounded_type(
+        const ::fastdds::dds::Topic* topic) const
+{
+#if FASTRTPS_VERSION_MINOR >= 2
+    ::fastdds::dds::TypeSupport type_support = dds_participant_->find_type(topic->get_type_name());
+    return !type_support.empty() && type_support->is_bounded();
+#else
+    (void)topic;
+    return false;
+#endif //  if FASTRTPS_VERSION_MINOR >= 2
+}
+
+void Participant::parse_transport(
+        const YAML::Node& config)
+{
+    try
+    {
+        if (!config.IsMap())
+        {
+            throw DDSMiddlewareException(
+                      logger_, "The node 'transport' of the 'participant' configuration must be a map");
+        }
+
+        if (config["shm"])
+        {
+            const YAML::Node& shm = config["shm"];
+            if (shm.IsMap())
+            {
+                transport_.shm = true;
+                if (shm["segment_size"])
+                {
+                    transport_.shm_segment_size = shm["segment_size"].as<uint32_t>();
+                }
+            }
+            else
+            {
+                transport_.shm = shm.as<bool>();
+            }
+        }
+
+        // UDP is kept along with shared memory unless explicitly disabled, to reach peers in other hosts
+        if (config["udp"])
+        {
+            transport_.udp = config["udp"].as<bool>();
+        }
+
+        if (config["data_sharing"])
+        {
+            const YAML::Node& data_sharing = config["data_sharing"];
+            if (data_sharing.IsMap())
+            {
+                transport_.data_sharing = true;
+                if (data_sharing["directory"])
+                {
+                    transport_.data_sharing_directory = data_sharing["directory"].as<std::string>();
+                }
+            }
+            else
+            {
+                transport_.data_sharing = data_sharing.as<bool>();
+            }
+        }
+    }
+    catch (const YAML::Exception& e)
+    {
+        std::ostringstream err;
+        err << "Invalid 'transport' configuration for the Fast DDS participant: " << e.what();
+
+        throw DDSMiddlewareException(logger_, err.str());
+    }
+
+    if (!transport_.shm && !transport_.udp)
+    {
+        throw DDSMiddlewareException(
+                  logger_, "Invalid 'transport' configuration for the Fast DDS participant: "
+                  "at least one of 'shm' or 'udp' must be enabled");
+    }
+
+    transport_.configured = true;
+
+    logger_ << utils::Logger::Level::INFO
+            << "Fast DDS participant transports: " << (transport_.shm ? "SHM " : "")
+            << (transport_.udp ? "UDPv4" : "") << std::endl;
+}
+
+const char* Participant::get_flow_controller_name(
+        const std::string& name) const
+{
+    auto flow_controller = flow_controllers_.find(name);
+    return flow_controllers_.end() == flow_controller ? nullptr : flow_controller->first.c_str();
+}
+
+void Participant::parse_flow_controllers(
+        const YAML::Node& config)
+{
+#if FASTRTPS_VERSION_MINOR >= 4
+    try
+    {
+        if (!config.IsMap())
+        {
+            throw DDSMiddlewareException(
+                      logger_, "The node 'flow_controllers' of the 'participant' configuration must be a map");
+        }
+
+        for (const auto& flow_controller : config)
+        {
+            FlowControllerSettings settings;
+            if (flow_controller.second["max_bytes_per_period"])
+            {
+                settings.max_bytes_per_period = flow_controller.second["max_bytes_per_period"].as<int32_t>();
+            }
+
+            if (flow_controller.second["period_ms"])
+            {
+                settings.period_ms = flow_controller.second["period_ms"].as<uint64_t>();
+            }
+
+            if (0 >= settings.max_bytes_per_period || 0 == settings.period_ms)
+            {
+                std::ostringstream err;
+                err << "Invalid flow controller '" << flow_controller.first.as<std::string>()
+                    << "': 'max_bytes_per_period' and 'period_ms' must be greater than zero";
+
+                throw DDSMiddlewareException(logger_, err.str());
+            }
+
+            flow_controllers_.emplace(flow_controller.first.as<std::string>(), settings);
+        }
+    }
+    catch (const YAML::Exception& e)
+    {
+        std::ostringstream err;
+        err << "Invalid 'flow_controllers' configuration for the Fast DDS participant: " << e.what();
+
+        throw DDSMiddlewareException(logger_, err.str());
+    }
+#else
+    (void)config;
+    throw DDSMiddlewareException(logger_, "Flow controllers require Fast DDS 2.4 or later");
+#endif //  if FASTRTPS_VERSION_MINOR >= 4
+}
+
+void Participant::configure_flow_controllers(
+        ::fastdds::dds::DomainParticipantQos& qos) const
+{
+#if FASTRTPS_VERSION_MINOR >= 4
+    for (const auto& flow_controller : flow_controllers_)
+    {
+        auto descriptor = std::make_shared<::fastdds::rtps::FlowControllerDescriptor>();
+        // The name is kept by this Participant, as Fast DDS does not copy it
+        descriptor->name = flow_controller.first.c_str();
+        descriptor->max_bytes_per_period = flow_controller.second.max_bytes_per_period;
+        descriptor->period_ms = flow_controller.second.period_ms;
+        qos.flow_controllers().push_back(descriptor);
+    }
+#else
+    (void)qos;
+#endif //  if FASTRTPS_VERSION_MINOR >= 4
+}
+
+void Participant::configure_transports(
+        ::fastdds::dds::DomainParticipantQos& qos) const
+{
+    // By default use UDPv4 due to communication failures between dockers sharing the network with the host
+    // When it is solved in Fast-DDS, the default builtin transports could be used instead.
+    qos.transport().use_builtin_transports = false;
+    qos.transport().user_transports.clear();
+
+    if (transport_.shm)
+    {
+        auto shm_transport = std::make_shared<::fastdds::rtps::SharedMemTransportDescriptor>();
+        if (0 < transport_.shm_segment_size)
+        {
+            shm_transport->segment_size(transport_.shm_segment_size);
+            // Each message must fit in the segment
+            if (shm_transport->max_message_size() > transport_.shm_segment_size)
+            {
+                shm_transport->max_message_size(transport_.shm_segment_size);
+            }
+        }
+        qos.transport().user_transports.push_back(shm_transport);
+    }
+
+    if (transport_.udp)
+    {
+        auto udp_transport = std::make_shared<::fastdds::rtps::UDPv4TransportDescriptor>();
+        qos.transport().user_transports.push_back(udp_transport);
+    }
+}
+
 static void set_qos_from_attributes(
         ::fastdds::dds::DomainParticipantQos& qos,
         const eprosima::fastrtps::rtps::RTPSParticipantAttributes& attr)
@@ -367,6 +795,18 @@ static void set_qos_from_attributes(
         ::fastdds::dds::DomainParticipantQos qos = ::fastdds::dds::PARTICIPANT_QOS_DEFAULT;
         set_qos_from_attributes(qos, attr.rtps);
 
+        if (transport_.configured)
+        {
+            configure_transports(qos);
+        }
+
+        configure_flow_controllers(qos);
+
+        if (ignore_local_endpoints_)
+        {
+            set_ignore_local_endpoints(qos);
+        }
+
         return ::fastdds::dds::DomainParticipantFactory::get_instance()->
                create_participant(attr.domainId, qos);
     }
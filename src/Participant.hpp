@@ -18,18 +18,27 @@
 #define _IS_SH_FASTDDS__INTERNAL__PARTICIPANT_HPP_
 
 #include "DDSMiddlewareException.hpp"
+#include "Metrics.hpp"
 
 #include <fastdds/dds/core/Entity.hpp>
 #include <fastdds/dds/domain/DomainParticipant.hpp>
 #include <fastdds/dds/domain/DomainParticipantFactory.hpp>
 #include <fastdds/dds/domain/DomainParticipantListener.hpp>
+#include <fastdds/dds/publisher/qos/DataWriterQos.hpp>
+#include <fastdds/dds/subscriber/qos/DataReaderQos.hpp>
+#include <fastdds/dds/topic/TypeSupport.hpp>
 #include <fastrtps/types/DynamicType.h>
 
+#include <is/core/Message.hpp>
 #include <is/utils/Log.hpp>
 
 #include <yaml-cpp/yaml.h>
 
+#include <chrono>
+#include <condition_variable>
 #include <map>
+#include <mutex>
+#include <optional>
 
 namespace fastdds = eprosima::fastdds;
 
@@ -38,6 +47,11 @@ namespace is {
 namespace sh {
 namespace fastdds {
 
+/**
+ * @brief Forward declaration.
+ */
+class XTypesPubSubType;
+
 /**
  * @class Participant
  *        This class represents a <a href="https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/domain/domainParticipant/domainParticipant.html">
@@ -79,6 +93,26 @@ public:
      *              that corresponds to the configuration profile that we want this Participant
      *              to be configured with.
      *
+     *            Optionally, `ignore_local_endpoints` can be set to `false` so that the DDS entities
+     *            created by this Participant match each other.
+     *
+     *            Optionally, a `transport` map selects the transports of the *DomainParticipant*,
+     *            overriding those of the XML profile, if any:
+     *
+     *            - `shm`: Enables the shared memory transport, for peers in the same host. It can be
+     *              `true` or a map with its `segment_size`, in bytes. Disabled by default.
+     *
+     *            - `udp`: Enables the UDPv4 transport. Enabled by default, even along with `shm`.
+     *
+     *            - `data_sharing`: Enables (`true`) or disables (`false`) the data-sharing delivery
+     *              between DataWriters and DataReaders in the same host. It is turned on for bounded
+     *              types and left in automatic mode for the others. It can also be a map with the
+     *              `directory` of the shared files. If not set, the *Fast DDS* default applies.
+     *
+     *            Optionally, a `flow_controllers` map defines, by name, the flow controllers which
+     *            the asynchronous publishers can use, each with its `max_bytes_per_period` and `period_ms`.
+     *            They require *Fast DDS* 2.4 or later.
+     *
      * @throws DDSMiddlewareException If the XML profile was incorrect and, thus, the
      *         *DomainParticipant* could not be created.
      */
@@ -124,6 +158,35 @@ public:
             const std::string& type_name,
             fastrtps::types::DynamicTypeBuilder* builder);
 
+    /**
+     * @brief Register an *xtypes* type within the DDS participant, using an XTypesPubSubType
+     *        type support, so that *xtypes* data can be written and read directly. Also, register the
+     *        associated DDS topic.
+     *
+     * @param[in] topic_name The topic name to be associated to the type.
+     *
+     * @param[in] type The *xtypes* definition of the type.
+     *
+     * @param[in] builder A builder for the equivalent *Dynamic Type*, used to compute its maximum size.
+     *
+     * @throws DDSMiddlewareException If the type could not be registered, or if it was already registered
+     *         as a *Dynamic Type*.
+     */
+    void register_xtypes_type(
+            const std::string& topic_name,
+            const xtypes::DynamicType& type,
+            fastrtps::types::DynamicTypeBuilder* builder);
+
+    /**
+     * @brief Get the type support registered with direct serialization for a topic.
+     *
+     * @param[in] topic_name The topic name.
+     *
+     * @returns The type support, or `nullptr` if the topic type was not registered with direct serialization.
+     */
+    XTypesPubSubType* get_xtypes_type(
+            const std::string& topic_name) const;
+
     /**
      * @brief Create an empty dynamic data object for the specified topic.
      *
@@ -193,6 +256,63 @@ public:
             ::fastdds::dds::Topic* topic,
             ::fastdds::dds::DomainEntity* entity);
 
+    /**
+     * @brief Notify the thread spinning the *Integration Service* system handle that something
+     *        happened: an entity matched or unmatched, or new work is waiting to be processed.
+     */
+    void notify_event();
+
+    /**
+     * @brief Wait until some event is notified, or the timeout expires.
+     *        The notified events are consumed.
+     *
+     * @param[in] timeout Maximum time to wait.
+     *
+     * @returns `true` if some event was notified, or `false` if the timeout expired.
+     */
+    bool wait_for_event(
+            std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Get the metrics of the DDS entities created on top of this participant.
+     */
+    Metrics& metrics();
+
+    /**
+     * @brief Get the name of a flow controller defined in the configuration.
+     *
+     * @param[in] name The name of the flow controller.
+     *
+     * @returns The name, owned by this Participant so that it can be used in the QoS of a DataWriter,
+     *          or `nullptr` if there is no such flow controller.
+     */
+    const char* get_flow_controller_name(
+            const std::string& name) const;
+
+    /**
+     * @brief Apply the configured data-sharing delivery to the QoS of a new DataWriter.
+     *        It is only forced for the topics of bounded types.
+     *
+     * @param[in,out] qos The QoS to modify.
+     *
+     * @param[in] topic The topic of the DataWriter.
+     */
+    void configure_data_sharing(
+            ::fastdds::dds::DataWriterQos& qos,
+            const ::fastdds::dds::Topic* topic) const;
+
+    /**
+     * @brief Apply the configured data-sharing delivery to the QoS of a new DataReader.
+     *        It is only forced for the topics of bounded types.
+     *
+     * @param[in,out] qos The QoS to modify.
+     *
+     * @param[in] topic The topic of the DataReader.
+     */
+    void configure_data_sharing(
+            ::fastdds::dds::DataReaderQos& qos,
+            const ::fastdds::dds::Topic* topic) const;
+
 private:
 
     /**
@@ -210,17 +330,93 @@ private:
     ::fastdds::dds::DomainParticipant* create_participant_with_profile(
         const std::string& profile_name);
 
+    /**
+     * @brief Read the `transport` map of the configuration.
+     *
+     * @param[in] config The `transport` configuration node.
+     *
+     * @throws DDSMiddlewareException if the configuration is not valid.
+     */
+    void parse_transport(
+            const YAML::Node& config);
+
+    /**
+     * @brief Check whether the type registered for a topic has a bounded serialized size,
+     *        so that data-sharing can be forced for its entities.
+     *
+     * @param[in] topic The topic whose type is checked.
+     */
+    bool is_bounded_type(
+            const ::fastdds::dds::Topic* topic) const;
+
+    /**
+     * @brief Replace the transports of a *DomainParticipant* QoS with the configured ones.
+     *
+     * @param[in,out] qos The QoS to modify.
+     */
+    void configure_transports(
+            ::fastdds::dds::DomainParticipantQos& qos) const;
+
+    /**
+     * @brief Read the `flow_controllers` map of the configuration.
+     *
+     * @param[in] config The `flow_controllers` configuration node.
+     *
+     * @throws DDSMiddlewareException if the configuration is not valid.
+     */
+    void parse_flow_controllers(
+            const YAML::Node& config);
+
+    /**
+     * @brief Add the configured flow controllers to a *DomainParticipant* QoS.
+     *
+     * @param[in,out] qos The QoS to modify.
+     */
+    void configure_flow_controllers(
+            ::fastdds::dds::DomainParticipantQos& qos) const;
+
+    /**
+     * @brief Limits of a flow controller.
+     */
+    struct FlowControllerSettings
+    {
+        int32_t max_bytes_per_period = 0;
+        uint64_t period_ms = 100;
+    };
+
+    /**
+     * @brief Transports used by the *DomainParticipant*.
+     */
+    struct TransportSettings
+    {
+        bool configured = false;
+        bool shm = false;
+        uint32_t shm_segment_size = 0;
+        bool udp = true;
+        std::optional<bool> data_sharing;
+        std::string data_sharing_directory;
+    };
 
     /**
      * Class members.
      */
     ::fastdds::dds::DomainParticipant* dds_participant_;
+    bool ignore_local_endpoints_;
+    TransportSettings transport_;
+    std::map<std::string, FlowControllerSettings> flow_controllers_;
 
     std::map<std::string, fastrtps::types::DynamicPubSubType> types_;
+    std::map<std::string, ::fastdds::dds::TypeSupport> xtypes_types_;
     std::map<std::string, std::string> topic_to_type_;
     std::map<::fastdds::dds::Topic*, std::set<::fastdds::dds::DomainEntity*> > topic_to_entities_;
     std::mutex topic_to_entities_mtx_;
 
+    uint32_t pending_events_;
+    std::mutex event_mtx_;
+    std::condition_variable event_cv_;
+
+    Metrics metrics_;
+
     is::utils::Logger logger_;
 };
 
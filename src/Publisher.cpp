@@ -17,41 +17,131 @@
 
 #include "Publisher.hpp"
 #include "Conversion.hpp"
+#include "QosConfiguration.hpp"
+#include "XTypesPubSubType.hpp"
 
 #include <fastdds/dds/publisher/PublisherListener.hpp>
 #include <fastdds/dds/topic/Topic.hpp>
 #include <fastdds/dds/publisher/DataWriter.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 namespace eprosima {
 namespace is {
 namespace sh {
 namespace fastdds {
 
+constexpr std::size_t Publisher::DEFAULT_PUBLICATION_QUEUE_SIZE;
+
 Publisher::Publisher(
         Participant* participant,
         const std::string& topic_name,
         const xtypes::DynamicType& message_type,
         const YAML::Node& config)
     : participant_(participant)
+    , direct_serialization_(false)
+    , data_pool_(
+        [participant, topic_name]()
+        {
+            return participant->create_dynamic_data(topic_name);
+        },
+        [participant](fastrtps::types::DynamicData* data)
+        {
+            participant->delete_dynamic_data(data);
+        },
+        std::max(1u, std::thread::hardware_concurrency()))
+    , loan_type_(nullptr)
     , topic_name_(topic_name)
+    , metrics_(participant->metrics().topic("publisher", topic_name))
     , logger_("is::sh::FastDDS::Publisher")
 {
-    fastrtps::types::DynamicTypeBuilder* builder = Conversion::create_builder(message_type);
+    uint32_t log_sampling = LogSampler::DEFAULT_ONE_IN;
+    bool asynchronous = false;
+    std::size_t queue_size = DEFAULT_PUBLICATION_QUEUE_SIZE;
+    std::string flow_controller;
 
-    if (builder != nullptr)
+    try
     {
-        participant->register_dynamic_type(topic_name, message_type.name(), builder);
+        if (config["direct_serialization"])
+        {
+            direct_serialization_ = config["direct_serialization"].as<bool>();
+        }
+
+        if (config["log_sampling"])
+        {
+            log_sampling = config["log_sampling"].as<uint32_t>();
+        }
+
+        if (config["publication"])
+        {
+            const YAML::Node& publication = config["publication"];
+            if (publication["asynchronous"])
+            {
+                asynchronous = publication["asynchronous"].as<bool>();
+            }
+
+            if (publication["queue_size"])
+            {
+                queue_size = publication["queue_size"].as<std::size_t>();
+            }
+
+            if (publication["flow_controller"])
+            {
+                flow_controller = publication["flow_controller"].as<std::string>();
+            }
+        }
     }
-    else
+    catch (const YAML::Exception& e)
+    {
+        std::ostringstream err;
+        err << "Invalid configuration for topic '" << topic_name << "': " << e.what();
+
+        throw DDSMiddlewareException(logger_, err.str());
+    }
+
+    if (0 == log_sampling)
+    {
+        std::ostringstream err;
+        err << "Invalid configuration for topic '" << topic_name
+            << "': 'log_sampling' must be greater than zero";
+
+        throw DDSMiddlewareException(logger_, err.str());
+    }
+    message_log_.one_in(log_sampling);
+
+    if (0 == queue_size)
+    {
+        std::ostringstream err;
+        err << "Invalid configuration for topic '" << topic_name
+            << "': 'publication.queue_size' must be greater than zero";
+
+        throw DDSMiddlewareException(logger_, err.str());
+    }
+
+    fastrtps::types::DynamicTypeBuilder* builder = Conversion::create_builder(message_type);
+
+    if (builder == nullptr)
     {
         throw DDSMiddlewareException(
                   logger_, "Cannot create builder for type " + message_type.name());
     }
 
-    dynamic_data_ = participant->create_dynamic_data(topic_name);
+    if (direct_serialization_)
+    {
+        participant->register_xtypes_type(topic_name, message_type, builder);
+    }
+    else
+    {
+        participant->register_dynamic_type(topic_name, message_type.name(), builder);
+
+        // Build the conversion plan and a first DynamicData now, so that the first publication does not pay for them
+        Conversion::prepare_plan(message_type);
+        data_pool_.release(data_pool_.acquire());
+    }
 
     // Retrieve DDS participant
     ::fastdds::dds::DomainParticipant* dds_participant = participant->get_dds_participant();
@@ -104,6 +194,7 @@ Publisher::Publisher(
 
     // Create DDS datawriter
     ::fastdds::dds::DataWriterQos datawriter_qos = ::fastdds::dds::DATAWRITER_QOS_DEFAULT;
+    participant_->configure_data_sharing(datawriter_qos, dds_topic_);
     if (config["service_instance_name"])
     {
         fastrtps::rtps::Property instance_property;
@@ -112,6 +203,30 @@ Publisher::Publisher(
         datawriter_qos.properties().properties().emplace_back(std::move(instance_property));
     }
 
+    if (config["qos"])
+    {
+        QosConfiguration::apply(config["qos"], topic_name, datawriter_qos);
+    }
+
+    if (!flow_controller.empty())
+    {
+        const char* flow_controller_name = participant->get_flow_controller_name(flow_controller);
+        if (nullptr == flow_controller_name)
+        {
+            std::ostringstream err;
+            err << "Invalid configuration for topic '" << topic_name << "': flow controller '"
+                << flow_controller << "' is not defined in the participant";
+
+            throw DDSMiddlewareException(logger_, err.str());
+        }
+
+#if FASTRTPS_VERSION_MINOR >= 4
+        // Flow controllers only apply to asynchronous datawriters
+        datawriter_qos.publish_mode().kind = ::fastdds::dds::ASYNCHRONOUS_PUBLISH_MODE;
+        datawriter_qos.publish_mode().flow_controller_name = flow_controller_name;
+#endif //  if FASTRTPS_VERSION_MINOR >= 4
+    }
+
     dds_datawriter_ = dds_publisher_->create_datawriter(dds_topic_, datawriter_qos, this);
     if (dds_datawriter_)
     {
@@ -126,12 +241,39 @@ Publisher::Publisher(
 
         throw DDSMiddlewareException(logger_, err.str());
     }
+
+#if FASTRTPS_VERSION_MINOR >= 2
+    if (direct_serialization_)
+    {
+        XTypesPubSubType* type_support = participant->get_xtypes_type(topic_name);
+        if (nullptr != type_support && type_support->plain())
+        {
+            loan_type_ = type_support;
+
+            logger_ << utils::Logger::Level::DEBUG
+                    << "Messages for topic '" << topic_name << "' will be written into loaned samples" << std::endl;
+        }
+    }
+#endif //  if FASTRTPS_VERSION_MINOR >= 2
+
+    if (asynchronous)
+    {
+        publication_queue_ = std::make_unique<BatchQueue<::xtypes::DynamicData> >(queue_size);
+        publication_thread_ = std::thread(&Publisher::publication_function, this);
+
+        logger_ << utils::Logger::Level::DEBUG
+                << "Messages for topic '" << topic_name << "' will be published asynchronously" << std::endl;
+    }
 }
 
 Publisher::~Publisher()
 {
-    std::unique_lock<std::mutex> lock(data_mtx_);
-    participant_->delete_dynamic_data(dynamic_data_);
+    // The messages still queued are written before leaving
+    if (publication_queue_)
+    {
+        publication_queue_->stop();
+        publication_thread_.join();
+    }
 
     bool delete_topic = participant_->dissociate_topic_from_dds_entity(dds_topic_, dds_datawriter_);
 
@@ -148,25 +290,132 @@ Publisher::~Publisher()
 bool Publisher::publish(
         const ::xtypes::DynamicData& message)
 {
-    std::unique_lock<std::mutex> lock(data_mtx_);
+    // Printing the message may cost more than publishing it, so only do it when it is going to be shown
+    if (message_log_.enabled(logger_, utils::Logger::Level::INFO))
+    {
+        logger_ << utils::Logger::Level::INFO
+                << "Sending message from Integration Service to DDS for topic '" << topic_name_ << "': "
+                << "[[ " << message << " ]]" << std::endl;
+    }
+
+    metrics_->samples_in.fetch_add(1, std::memory_order_relaxed);
+
+    if (publication_queue_)
+    {
+        // The message must be copied, as it is converted and written later by the publication thread
+        const bool queued = publication_queue_->push(::xtypes::DynamicData(message));
+        metrics_->queue_depth.store(publication_queue_->size(), std::memory_order_relaxed);
+
+        if (!queued)
+        {
+            metrics_->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        return queued;
+    }
+
+    return write(message);
+}
 
-    logger_ << utils::Logger::Level::INFO
-            << "Sending message from Integration Service to DDS for topic '" << topic_name_ << "': "
-            << "[[ " << message << " ]]" << std::endl;
+bool Publisher::write(
+        const ::xtypes::DynamicData& message)
+{
+    bool success = false;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-    bool success = Conversion::xtypes_to_fastdds(message, dynamic_data_);
-    if (success)
+    if (nullptr != loan_type_)
     {
-        success = dds_datawriter_->write(static_cast<void*>(dynamic_data_));
+        success = publish_loaned(message);
+    }
+    else if (direct_serialization_)
+    {
+        // The message is serialized within the write call, so it can be passed as it is
+        success = dds_datawriter_->write(const_cast<::xtypes::DynamicData*>(&message));
+        metrics_->delivery.record(std::chrono::steady_clock::now() - start);
     }
     else
     {
+        fastrtps::types::DynamicData* dynamic_data = data_pool_.acquire();
+
+        success = Conversion::xtypes_to_fastdds(message, dynamic_data);
+        const std::chrono::steady_clock::time_point converted = std::chrono::steady_clock::now();
+        metrics_->conversion.record(converted - start);
+
+        if (success)
+        {
+            success = dds_datawriter_->write(static_cast<void*>(dynamic_data));
+            metrics_->delivery.record(std::chrono::steady_clock::now() - converted);
+        }
+        else
+        {
+            logger_ << utils::Logger::Level::ERROR
+                    << "Failed to convert message from Integration Service to DDS for topic '"
+                    << topic_name_ << "': [[ " << message << " ]]" << std::endl;
+        }
+
+        data_pool_.release(dynamic_data);
+    }
+
+    (success ? metrics_->samples_out : metrics_->dropped).fetch_add(1, std::memory_order_relaxed);
+
+    return success;
+}
+
+void Publisher::publication_function()
+{
+    std::vector<::xtypes::DynamicData> batch;
+    while (publication_queue_->pop_all(batch))
+    {
+        metrics_->queue_depth.store(publication_queue_->size(), std::memory_order_relaxed);
+
+        for (const ::xtypes::DynamicData& message : batch)
+        {
+            write(message);
+        }
+    }
+}
+
+bool Publisher::publish_loaned(
+        const ::xtypes::DynamicData& message)
+{
+#if FASTRTPS_VERSION_MINOR >= 2
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    void* sample = nullptr;
+    if (fastrtps::types::ReturnCode_t::RETCODE_OK != dds_datawriter_->loan_sample(sample))
+    {
+        // All the samples may be in use, e.g. by data-sharing readers which did not take them yet
+        const bool success = dds_datawriter_->write(const_cast<::xtypes::DynamicData*>(&message));
+        metrics_->delivery.record(std::chrono::steady_clock::now() - start);
+        return success;
+    }
+
+    if (!loan_type_->serialize_plain(message, sample))
+    {
+        dds_datawriter_->discard_loan(sample);
+
         logger_ << utils::Logger::Level::ERROR
-                << "Failed to convert message from Integration Service to DDS for topic '"
+                << "Failed to serialize message from Integration Service to DDS for topic '"
                 << topic_name_ << "': [[ " << message << " ]]" << std::endl;
+
+        return false;
     }
 
+    const std::chrono::steady_clock::time_point converted = std::chrono::steady_clock::now();
+    metrics_->conversion.record(converted - start);
+
+    // On success, the datawriter takes the loan back
+    const bool success = dds_datawriter_->write(sample);
+    if (!success)
+    {
+        dds_datawriter_->discard_loan(sample);
+    }
+    metrics_->delivery.record(std::chrono::steady_clock::now() - converted);
+
     return success;
+#else
+    (void)message;
+    return false;
+#endif //  if FASTRTPS_VERSION_MINOR >= 2
 }
 
 const std::string& Publisher::topic_name() const
@@ -183,6 +432,8 @@ void Publisher::on_publication_matched(
         ::fastdds::dds::DataWriter* /*writer*/,
         const ::fastdds::dds::PublicationMatchedStatus& info)
 {
+    participant_->notify_event();
+
     if (1 == info.current_count_change)
     {
         logger_ << utils::Logger::Level::INFO
@@ -18,7 +18,10 @@
 #ifndef _IS_SH_FASTDDS__INTERNAL__PUBLISHER_HPP_
 #define _IS_SH_FASTDDS__INTERNAL__PUBLISHER_HPP_
 
+#include "BatchQueue.hpp"
 #include "DDSMiddlewareException.hpp"
+#include "LogSampler.hpp"
+#include "ObjectPool.hpp"
 #include "Participant.hpp"
 
 #include <is/core/Message.hpp>
@@ -27,6 +30,9 @@
 
 #include <fastdds/dds/publisher/Publisher.hpp>
 
+#include <memory>
+#include <thread>
+
 namespace fastdds = eprosima::fastdds;
 
 namespace eprosima {
@@ -60,6 +66,11 @@ class Publisher
 {
 public:
 
+    /**
+     * @brief Default maximum number of messages waiting to be written, in asynchronous mode.
+     */
+    static constexpr std::size_t DEFAULT_PUBLICATION_QUEUE_SIZE = 1024;
+
     /**
      * @brief Construct a new Publisher object.
      *
@@ -73,6 +84,18 @@ public:
      * @param[in] config Specific configuration regarding this publisher, in *YAML* format.
      *            Allowed fields are:
      *            - `service_instance_name`: Specify the DDS RPC service instance name property.
+     *            - `direct_serialization`: If `true`, messages are serialized straight from their
+     *              *xtypes* representation, without converting them into a *Fast DDS* DynamicData.
+     *              For plain types, they are serialized into samples loaned by the datawriter.
+     *            - `log_sampling`: Only log the contents of one out of every `log_sampling` messages.
+     *            - `qos`: QoS of the datawriter, as described in QosConfiguration.
+     *            - `publication`: A map with the following fields:
+     *              - `asynchronous`: If `true`, publish() just queues the messages, which are converted
+     *                and written in batches by a background thread.
+     *              - `queue_size`: Maximum number of queued messages. When the queue is full, publish()
+     *                blocks until the background thread takes them. Defaults to DEFAULT_PUBLICATION_QUEUE_SIZE.
+     *              - `flow_controller`: Name of a flow controller defined in the participant configuration.
+     *                It makes the datawriter publish asynchronously.
      *
      * @throws DDSMiddlewareException if some error occurs while creating the *Fast DDS* publisher.
      */
@@ -115,6 +138,10 @@ public:
 
     /**
      * @brief Inherited from TopicPublisher.
+     *
+     *        It can be called concurrently: each call converts the message into its own
+     *        *Fast DDS* DynamicData, taken from a pool, and only the datawriter is shared.
+     *        In asynchronous mode, it only copies the message into the publication queue.
      */
     bool publish(
             const xtypes::DynamicData& message) override;
@@ -136,6 +163,32 @@ public:
 
 private:
 
+    /**
+     * @brief Convert a message and write it to DDS, in the calling thread.
+     *
+     * @param[in] message The message to write.
+     *
+     * @returns `true` if the message was written.
+     */
+    bool write(
+            const xtypes::DynamicData& message);
+
+    /**
+     * @brief Main loop of the publication thread, which writes the queued messages in batches.
+     */
+    void publication_function();
+
+    /**
+     * @brief Serialize a message of a plain type into a sample loaned by the datawriter, and write it.
+     *        If no sample can be loaned, the message is written as usual.
+     *
+     * @param[in] message The message to publish.
+     *
+     * @returns `true` if the message was written.
+     */
+    bool publish_loaned(
+            const xtypes::DynamicData& message);
+
     /**
      * @brief Inherited from *DataWriterListener*.
      */
@@ -151,12 +204,17 @@ private:
     ::fastdds::dds::Topic* dds_topic_;
     ::fastdds::dds::DataWriter* dds_datawriter_;
 
-    fastrtps::types::DynamicData* dynamic_data_;
-    std::mutex data_mtx_;
+    bool direct_serialization_;
+    ObjectPool<fastrtps::types::DynamicData> data_pool_;
+    XTypesPubSubType* loan_type_;
+    std::unique_ptr<BatchQueue<xtypes::DynamicData> > publication_queue_;
+    std::thread publication_thread_;
 
     const std::string topic_name_;
+    std::shared_ptr<TopicMetrics> metrics_;
 
     utils::Logger logger_;
+    LogSampler message_log_;
 };
 
 } //  namespace fastdds
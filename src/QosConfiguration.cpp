@@ -0,0 +1,237 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "QosConfiguration.hpp"
+#include "DDSMiddlewareException.hpp"
+
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+namespace {
+
+/**
+ * @brief Read a field whose value must be one of a set of names.
+ *
+ * @throws std::invalid_argument if the value is not one of the names.
+ */
+template<typename Kind>
+Kind parse_kind(
+        const YAML::Node& node,
+        const std::string& field,
+        const std::map<std::string, Kind>& kinds)
+{
+    const std::string value = node.as<std::string>();
+
+    auto kind = kinds.find(value);
+    if (kinds.end() == kind)
+    {
+        std::ostringstream err;
+        err << "'" << field << "' must be one of";
+        for (const auto& name : kinds)
+        {
+            err << " '" << name.first << "'";
+        }
+        err << ", but it is '" << value << "'";
+
+        throw std::invalid_argument(err.str());
+    }
+
+    return kind->second;
+}
+
+/**
+ * @brief Read a field which must be a positive number.
+ *
+ * @throws std::invalid_argument if the value is not positive.
+ */
+int32_t parse_positive(
+        const YAML::Node& node,
+        const std::string& field)
+{
+    const int32_t value = node.as<int32_t>();
+    if (0 >= value)
+    {
+        throw std::invalid_argument("'" + field + "' must be greater than zero");
+    }
+
+    return value;
+}
+
+} //  anonymous namespace
+
+// Static member initialization
+utils::Logger QosConfiguration::logger_("is::sh::FastDDS::QosConfiguration");
+
+void QosConfiguration::apply(
+        const YAML::Node& config,
+        const std::string& topic_name,
+        ::fastdds::dds::DataWriterQos& qos)
+{
+    try
+    {
+        apply_common(config, qos);
+
+        if (config["publish_mode"])
+        {
+            qos.publish_mode().kind = parse_kind<::fastdds::dds::PublishModeQosPolicyKind>(
+                config["publish_mode"], "publish_mode",
+                {
+                    {"synchronous", ::fastdds::dds::SYNCHRONOUS_PUBLISH_MODE},
+                    {"asynchronous", ::fastdds::dds::ASYNCHRONOUS_PUBLISH_MODE}
+                });
+        }
+    }
+    catch (const YAML::Exception& e)
+    {
+        invalid(topic_name, e.what());
+    }
+    catch (const std::invalid_argument& e)
+    {
+        invalid(topic_name, e.what());
+    }
+}
+
+void QosConfiguration::apply(
+        const YAML::Node& config,
+        const std::string& topic_name,
+        ::fastdds::dds::DataReaderQos& qos)
+{
+    try
+    {
+        apply_common(config, qos);
+
+        if (config["publish_mode"])
+        {
+            throw std::invalid_argument("'publish_mode' only applies to publishers");
+        }
+    }
+    catch (const YAML::Exception& e)
+    {
+        invalid(topic_name, e.what());
+    }
+    catch (const std::invalid_argument& e)
+    {
+        invalid(topic_name, e.what());
+    }
+}
+
+template<typename Qos>
+void QosConfiguration::apply_common(
+        const YAML::Node& config,
+        Qos& qos)
+{
+    if (!config.IsMap())
+    {
+        throw std::invalid_argument("it must be a map");
+    }
+
+    if (config["reliability"])
+    {
+        qos.reliability().kind = parse_kind<::fastdds::dds::ReliabilityQosPolicyKind>(
+            config["reliability"], "reliability",
+            {
+                {"reliable", ::fastdds::dds::RELIABLE_RELIABILITY_QOS},
+                {"best_effort", ::fastdds::dds::BEST_EFFORT_RELIABILITY_QOS}
+            });
+    }
+
+    if (config["durability"])
+    {
+        qos.durability().kind = parse_kind<::fastdds::dds::DurabilityQosPolicyKind>(
+            config["durability"], "durability",
+            {
+                {"volatile", ::fastdds::dds::VOLATILE_DURABILITY_QOS},
+                {"transient_local", ::fastdds::dds::TRANSIENT_LOCAL_DURABILITY_QOS},
+                {"transient", ::fastdds::dds::TRANSIENT_DURABILITY_QOS},
+                {"persistent", ::fastdds::dds::PERSISTENT_DURABILITY_QOS}
+            });
+    }
+
+    if (config["history"])
+    {
+        const YAML::Node& history = config["history"];
+        if (history["kind"])
+        {
+            qos.history().kind = parse_kind<::fastdds::dds::HistoryQosPolicyKind>(
+                history["kind"], "history.kind",
+                {
+                    {"keep_last", ::fastdds::dds::KEEP_LAST_HISTORY_QOS},
+                    {"keep_all", ::fastdds::dds::KEEP_ALL_HISTORY_QOS}
+                });
+        }
+
+        if (history["depth"])
+        {
+            qos.history().depth = parse_positive(history["depth"], "history.depth");
+        }
+    }
+
+    if (config["resource_limits"])
+    {
+        const YAML::Node& limits = config["resource_limits"];
+        if (limits["max_samples"])
+        {
+            qos.resource_limits().max_samples = parse_positive(limits["max_samples"], "max_samples");
+        }
+
+        if (limits["max_instances"])
+        {
+            qos.resource_limits().max_instances = parse_positive(limits["max_instances"], "max_instances");
+        }
+
+        if (limits["max_samples_per_instance"])
+        {
+            qos.resource_limits().max_samples_per_instance = parse_positive(
+                limits["max_samples_per_instance"], "max_samples_per_instance");
+        }
+
+        if (limits["allocated_samples"])
+        {
+            qos.resource_limits().allocated_samples = parse_positive(
+                limits["allocated_samples"], "allocated_samples");
+        }
+    }
+
+    // Checked here, as Fast DDS would just fail to create the entity
+    if (::fastdds::dds::KEEP_LAST_HISTORY_QOS == qos.history().kind
+            && 0 < qos.resource_limits().max_samples_per_instance
+            && qos.history().depth > qos.resource_limits().max_samples_per_instance)
+    {
+        throw std::invalid_argument("'history.depth' cannot be greater than 'max_samples_per_instance'");
+    }
+}
+
+void QosConfiguration::invalid(
+        const std::string& topic_name,
+        const std::string& reason)
+{
+    std::ostringstream err;
+    err << "Invalid 'qos' configuration for topic '" << topic_name << "': " << reason;
+
+    throw DDSMiddlewareException(logger_, err.str());
+}
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_FASTDDS__INTERNAL__QOSCONFIGURATION_HPP_
+#define _IS_SH_FASTDDS__INTERNAL__QOSCONFIGURATION_HPP_
+
+#include <fastdds/dds/publisher/qos/DataWriterQos.hpp>
+#include <fastdds/dds/subscriber/qos/DataReaderQos.hpp>
+
+#include <is/utils/Log.hpp>
+
+#include <yaml-cpp/yaml.h>
+
+#include <string>
+
+namespace fastdds = eprosima::fastdds;
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+/**
+ * @struct QosConfiguration
+ *        Applies the `qos` map of a topic configuration to the QoS of its DDS entities.
+ *
+ *        The allowed fields, all of them optional, are:
+ *        - `reliability`: `reliable` or `best_effort`.
+ *        - `durability`: `volatile`, `transient_local`, `transient` or `persistent`.
+ *        - `history`: A map with the history `kind`, `keep_last` or `keep_all`,
+ *          and its `depth`, for `keep_last`.
+ *        - `resource_limits`: A map with any of `max_samples`, `max_instances`,
+ *          `max_samples_per_instance` and `allocated_samples`.
+ *        - `publish_mode`: `synchronous` or `asynchronous`. Only applies to datawriters.
+ *
+ *        The fields which are not given keep the values already set in the QoS.
+ */
+struct QosConfiguration
+{
+    /**
+     * @brief Apply a `qos` configuration to the QoS of a datawriter.
+     *
+     * @param[in] config The `qos` configuration node.
+     *
+     * @param[in] topic_name The topic of the datawriter, to report errors.
+     *
+     * @param[in,out] qos The QoS to modify.
+     *
+     * @throws DDSMiddlewareException if the configuration is not valid.
+     */
+    static void apply(
+            const YAML::Node& config,
+            const std::string& topic_name,
+            ::fastdds::dds::DataWriterQos& qos);
+
+    /**
+     * @brief Apply a `qos` configuration to the QoS of a datareader.
+     *
+     * @param[in] config The `qos` configuration node.
+     *
+     * @param[in] topic_name The topic of the datareader, to report errors.
+     *
+     * @param[in,out] qos The QoS to modify.
+     *
+     * @throws DDSMiddlewareException if the configuration is not valid.
+     */
+    static void apply(
+            const YAML::Node& config,
+            const std::string& topic_name,
+            ::fastdds::dds::DataReaderQos& qos);
+
+private:
+
+    /**
+     * @brief Apply the fields shared by datawriters and datareaders.
+     */
+    template<typename Qos>
+    static void apply_common(
+            const YAML::Node& config,
+            Qos& qos);
+
+    /**
+     * @brief Throw a DDSMiddlewareException describing an invalid `qos` configuration.
+     */
+    [[noreturn]] static void invalid(
+            const std::string& topic_name,
+            const std::string& reason);
+
+    /**
+     * Class members.
+     */
+    static utils::Logger logger_;
+};
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_FASTDDS__INTERNAL__QOSCONFIGURATION_HPP_
@@ -31,14 +31,19 @@
 #include <fastdds/dds/subscriber/InstanceState.hpp>
 #endif //  if FASTRTPS_VERSION_MINOR >= 2
 
+#include <algorithm>
 #include <functional>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 namespace eprosima {
 namespace is {
 namespace sh {
 namespace fastdds {
 
+constexpr std::size_t Server::DEFAULT_MAX_PENDING_REQUESTS;
+
 Server::Server(
         Participant* participant,
         const std::string& service_name,
@@ -49,13 +54,71 @@ Server::Server(
     , service_name_(service_name)
     , request_entities_(request_type)
     , reply_entities_(reply_type)
+    , received_pool_(
+        [&reply_type]()
+        {
+            return new ::xtypes::DynamicData(reply_type);
+        },
+        [](::xtypes::DynamicData* data)
+        {
+            delete data;
+        },
+        Conversion::is_reusable(reply_type) ? std::max(1u, std::thread::hardware_concurrency()) : 0)
+    , taken_pool_(
+        [participant, service_name]()
+        {
+            return participant->create_dynamic_data(service_name + "_Reply");
+        },
+        [participant](fastrtps::types::DynamicData* data)
+        {
+            participant->delete_dynamic_data(data);
+        },
+        Conversion::is_reusable(reply_type) ? std::max(1u, std::thread::hardware_concurrency()) : 0)
+    , reply_timeout_(0)
+    , max_pending_requests_(DEFAULT_MAX_PENDING_REQUESTS)
+    , writes_in_flight_(0)
     , matched_mtx_()
-    , pub_sub_matched_(0)
-    , stop_cleaner_(false)
-    , cleaner_thread_(&Server::cleaner_function, this)
+    , request_matched_(false)
+    , reply_matched_(false)
+    , stopping_(false)
+    , metrics_(participant->metrics().topic("server", service_name))
     , logger_("is::sh::FastDDS::Server")
+    , reception_pool_(
+        service_name,
+        config["reception"],
+        [participant]()
+        {
+            participant->notify_event();
+        })
 {
-    mtx_.lock(); // Lock mtx_ until datareader and datawriter have matched
+    try
+    {
+        if (config["reply_timeout_ms"])
+        {
+            reply_timeout_ = std::chrono::milliseconds(config["reply_timeout_ms"].as<uint32_t>());
+        }
+
+        if (config["max_pending_requests"])
+        {
+            max_pending_requests_ = config["max_pending_requests"].as<std::size_t>();
+        }
+    }
+    catch (const YAML::Exception& e)
+    {
+        std::ostringstream err;
+        err << "Invalid configuration for service '" << service_name << "': " << e.what();
+
+        throw DDSMiddlewareException(logger_, err.str());
+    }
+
+    if (0 == max_pending_requests_)
+    {
+        std::ostringstream err;
+        err << "Invalid configuration for service '" << service_name
+            << "': 'max_pending_requests' must be greater than zero";
+
+        throw DDSMiddlewareException(logger_, err.str());
+    }
 
     add_config(config);
 
@@ -86,7 +149,6 @@ Server::Server(
     }
 
     request_entities_.dynamic_data = participant->create_dynamic_data(service_name + "_Request");
-    reply_entities_.dynamic_data = participant->create_dynamic_data(service_name + "_Reply");
 
     // Retrieve DDS participant
     ::fastdds::dds::DomainParticipant* dds_participant = participant->get_dds_participant();
@@ -144,6 +206,7 @@ Server::Server(
 
         // Create DDS datawriter
         ::fastdds::dds::DataWriterQos datawriter_qos = ::fastdds::dds::DATAWRITER_QOS_DEFAULT;
+        participant_->configure_data_sharing(datawriter_qos, request_entities_.dds_topic);
 
         if (config["service_instance_name"])
         {
@@ -222,6 +285,7 @@ Server::Server(
 
         // Create DDS datareader
         ::fastdds::dds::DataReaderQos datareader_qos = ::fastdds::dds::DATAREADER_QOS_DEFAULT;
+        participant_->configure_data_sharing(datareader_qos, reply_entities_.dds_topic);
         ::fastdds::dds::ReliabilityQosPolicy rel_policy;
         rel_policy.kind = ::fastdds::dds::RELIABLE_RELIABILITY_QOS;
         datareader_qos.reliability(rel_policy);
@@ -261,16 +325,16 @@ Server::~Server()
     logger_ << utils::Logger::Level::INFO
             << "Waiting for current processing messages before quitting" << std::endl;
 
-    {
-        std::unique_lock<std::mutex> lock(cleaner_mtx_);
-        stop_cleaner_ = true;
-        cleaner_cv_.notify_one();
-    }
+    reply_entities_.dds_datareader->set_listener(nullptr);
 
-    if (cleaner_thread_.joinable())
+    // Release the callers waiting for the endpoints to match
     {
-        cleaner_thread_.join();
+        std::unique_lock<std::mutex> lock(matched_mtx_);
+        stopping_ = true;
     }
+    matched_cv_.notify_all();
+
+    reception_pool_.stop();
 
     logger_ << utils::Logger::Level::INFO
             << "All messages were processed. Quitting now..." << std::endl;
@@ -294,9 +358,6 @@ Server::~Server()
     }
 
     {
-        std::unique_lock<std::mutex> reply_lock(reply_entities_.data_mtx);
-        participant_->delete_dynamic_data(reply_entities_.dynamic_data);
-
         bool delete_topic = participant_->dissociate_topic_from_dds_entity(
             reply_entities_.dds_topic, reply_entities_.dds_datareader);
 
@@ -313,6 +374,42 @@ Server::~Server()
 bool Server::add_config(
         const YAML::Node& config)
 {
+    // Compile the member path of a discriminator, getting the name of the type it holds
+    auto compile_path = [&](
+        const ::xtypes::DynamicType& type,
+        const std::string& disc,
+        MemberPath& path,
+        std::string& type_name) -> bool
+            {
+                if (!Conversion::compile_member_path(type, disc, path))
+                {
+                    logger_ << utils::Logger::Level::ERROR
+                            << "Adding config for service '" << service_name_
+                            << "': invalid member '" << disc << "'" << std::endl;
+                    return false;
+                }
+
+                if (path.type->name().find("::") == 0)
+                {
+                    type_name = path.type->name().substr(2);
+                }
+                else
+                {
+                    type_name = path.type->name();
+                }
+                return true;
+            };
+
+    // The paths are registered with and without the leading `::`, to look up the request type names as they are
+    auto add_path = [](
+        std::unordered_map<std::string, MemberPath>& paths,
+        const std::string& type_name,
+        const MemberPath& path)
+            {
+                paths[type_name] = path;
+                paths["::" + type_name] = path;
+            };
+
     // Map discriminator to type from config
     if (config["remap"])
     {
@@ -321,27 +418,20 @@ bool Server::add_config(
             if (config["remap"]["dds"]["type"])
             {
                 std::string req;
+                MemberPath path;
                 std::string disc = config["remap"]["dds"]["type"].as<std::string>();
-                const ::xtypes::DynamicType& member_type =
-                        Conversion::resolve_discriminator_type(request_entities_.type, disc);
-
-                if (member_type.name().find("::") == 0)
-                {
-                    req = member_type.name().substr(2);
-                }
-                else
+                if (!compile_path(request_entities_.type, disc, path, req))
                 {
-                    req = member_type.name();
+                    return false;
                 }
 
-                type_to_discriminator_[req] = disc;
+                add_path(request_paths_, req, path);
                 if (config["type"])
                 {
                     if (config["type"].as<std::string>() != req)
                     {
                         // Add alias from other types
-                        // TODO - Solve path?
-                        type_to_discriminator_[config["type"].as<std::string>()] = disc;
+                        add_path(request_paths_, config["type"].as<std::string>(), path);
                     }
                 }
 
@@ -355,28 +445,21 @@ bool Server::add_config(
                 std::string req_alias;
                 if (config["remap"]["dds"]["request_type"])
                 {
+                    MemberPath path;
                     std::string disc = config["remap"]["dds"]["request_type"].as<std::string>();
-                    const ::xtypes::DynamicType& member_type =
-                            Conversion::resolve_discriminator_type(request_entities_.type, disc);
-
-                    if (member_type.name().find("::") == 0)
+                    if (!compile_path(request_entities_.type, disc, path, req))
                     {
-                        req = member_type.name().substr(2);
-                    }
-                    else
-                    {
-                        req = member_type.name();
+                        return false;
                     }
 
-                    type_to_discriminator_[req] = disc;
+                    add_path(request_paths_, req, path);
                     if (config["request_type"])
                     {
                         if (config["request_type"].as<std::string>() != req)
                         {
                             // Add alias from other types
-                            // TODO - Solve path?
                             req_alias = config["request_type"].as<std::string>();
-                            type_to_discriminator_[req_alias] = disc;
+                            add_path(request_paths_, req_alias, path);
                         }
                     }
 
@@ -388,35 +471,23 @@ bool Server::add_config(
                 if (config["remap"]["dds"]["reply_type"])
                 {
                     std::string rep;
+                    MemberPath path;
                     std::string disc = config["remap"]["dds"]["reply_type"].as<std::string>();
-                    const ::xtypes::DynamicType& member_type =
-                            Conversion::resolve_discriminator_type(reply_entities_.type, disc);
-
-                    if (member_type.name().find("::") == 0)
+                    if (!compile_path(reply_entities_.type, disc, path, rep))
                     {
-                        rep = member_type.name().substr(2);
-                    }
-                    else
-                    {
-                        rep = member_type.name();
+                        return false;
                     }
 
-                    request_reply_[req] = rep;
-                    type_to_discriminator_[rep] = disc;
-                    if (config["reply_type"])
+                    // The replies are looked up by the type of their request
+                    add_path(reply_paths_, req, path);
+                    if (!req_alias.empty())
                     {
-                        if (config["reply_type"].as<std::string>() != req)
-                        {
-                            // Add alias from other types
-                            // TODO - Solve path?
-                            type_to_discriminator_[config["reply_type"].as<std::string>()] = disc;
-                            request_reply_[req_alias] = rep;
-                        }
+                        add_path(reply_paths_, req_alias, path);
                     }
 
                     logger_ << utils::Logger::Level::DEBUG
                             << "Member '" << disc << "' has reply type '"
-                            << req << "'" << std::endl;
+                            << rep << "'" << std::endl;
                 }
             }
         }
@@ -431,57 +502,144 @@ void Server::call_service(
 {
     ::xtypes::DynamicData request(request_entities_.type);
 
-    if (is_request.type().name().find("::") == 0)
+    auto request_path = request_paths_.find(is_request.type().name());
+    Conversion::access_member_data(
+        request, request_paths_.end() != request_path ? request_path->second : root_path_) = is_request;
+
+    logger_ << utils::Logger::Level::INFO
+            << "Translating request from Integration Service to DDS for service request topic '"
+            << service_name_ << "_Request': [[ " << is_request << " ]]" << std::endl;
+
+    if (!wait_for_match())
     {
-        Conversion::access_member_data(request,
-                type_to_discriminator_[is_request.type().name().substr(2)]) = is_request;
+        return;
     }
-    else
+
+    expire_requests();
+
+    PendingRequest pending{call_handle, &client, &root_path_};
+
+    auto reply_path = reply_paths_.find(is_request.type().name());
+    if (reply_paths_.end() != reply_path)
     {
-        Conversion::access_member_data(request,
-                type_to_discriminator_[is_request.type().name()]) = is_request;
+        pending.reply_path = &reply_path->second;
     }
 
-    logger_ << utils::Logger::Level::INFO
-            << "Translating request from Integration Service to DDS for service request topic '"
-            << service_name_ << "_Request': [[ " << is_request << " ]]" << std::endl;
+    std::unique_lock<std::mutex> request_lock(request_entities_.data_mtx);
+    if (!Conversion::xtypes_to_fastdds(request, request_entities_.dynamic_data))
+    {
+        request_lock.unlock();
+        metrics_->dropped.fetch_add(1, std::memory_order_relaxed);
 
-    request_entities_.data_mtx.lock();
-    bool success = Conversion::xtypes_to_fastdds(request, request_entities_.dynamic_data);
+        logger_ << utils::Logger::Level::ERROR
+                << "Failed to convert request from Integration Service to DDS for "
+                << "service request topic '" << service_name_ << "_Request'" << std::endl;
 
-    if (success)
+        reply_default(pending);
+        return;
+    }
+
+    // The replies received while the request is being written are kept until its sample identity is known
     {
-        fastrtps::rtps::WriteParams params;
         std::unique_lock<std::mutex> lock(mtx_);
-        callhandle_client_[call_handle] = &client;
+        ++writes_in_flight_;
+    }
+
+    fastrtps::rtps::WriteParams params;
+    bool success = request_entities_.dds_datawriter->write(request_entities_.dynamic_data, params);
+    request_lock.unlock();
+
+    const fastrtps::rtps::SampleIdentity& sample_id = params.sample_identity();
+    fastrtps::types::DynamicData* early_reply = nullptr;
+    std::vector<PendingRequest> evicted;
+    std::vector<fastrtps::types::DynamicData*> unasked;
 
-        success = request_entities_.dds_datawriter->write(
-            request_entities_.dynamic_data, params);
-        request_entities_.data_mtx.unlock();
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        --writes_in_flight_;
 
-        if (!success)
+        if (success)
         {
-            logger_ << utils::Logger::Level::WARN
-                    << "Failed to publish to DDS service request topic '"
-                    << service_name_ << "_Request'" << std::endl;
+            auto early = early_replies_.find(sample_id);
+            if (early_replies_.end() != early)
+            {
+                early_reply = early->second;
+                early_replies_.erase(early);
+            }
+            else
+            {
+                // Give up the oldest requests to make room for the new one
+                while (pending_requests_.size() >= max_pending_requests_)
+                {
+                    auto oldest = pending_requests_.find(sent_requests_.front().second);
+                    if (pending_requests_.end() != oldest)
+                    {
+                        evicted.push_back(std::move(oldest->second));
+                        pending_requests_.erase(oldest);
+                    }
+                    sent_requests_.pop_front();
+                }
+
+                pending_requests_.emplace(sample_id, pending);
+                sent_requests_.emplace_back(std::chrono::steady_clock::now(), sample_id);
+
+                // Remove the replied requests, which are otherwise only skipped when they reach the front
+                if (sent_requests_.size() > 2 * max_pending_requests_)
+                {
+                    sent_requests_.erase(
+                        std::remove_if(sent_requests_.begin(), sent_requests_.end(),
+                        [this](const SentRequest& sent)
+                        {
+                            return pending_requests_.end() == pending_requests_.find(sent.second);
+                        }),
+                        sent_requests_.end());
+                }
+            }
         }
-        else
+
+        if (0 == writes_in_flight_)
         {
-            fastrtps::rtps::SampleIdentity sample = params.sample_identity();
-            sample_callhandle_[sample] = call_handle;
-            if (request_reply_.count(is_request.type().name()) > 0)
+            for (auto& reply : early_replies_)
             {
-                reply_id_type_[sample] = request_reply_[is_request.type().name()];
+                unasked.push_back(reply.second);
             }
+            early_replies_.clear();
         }
     }
-    else
+
+    for (fastrtps::types::DynamicData* reply : unasked)
     {
-        request_entities_.data_mtx.unlock();
+        metrics_->dropped.fetch_add(1, std::memory_order_relaxed);
 
-        logger_ << utils::Logger::Level::ERROR
-                << "Failed to convert request from Integration Service to DDS for "
-                << "service request topic '" << service_name_ << "_Request'" << std::endl;
+        logger_ << utils::Logger::Level::WARN
+                << "Received reply from unasked or expired request. Ignoring..." << std::endl;
+        taken_pool_.release(reply);
+    }
+
+    if (!success)
+    {
+        metrics_->dropped.fetch_add(1, std::memory_order_relaxed);
+
+        logger_ << utils::Logger::Level::WARN
+                << "Failed to publish to DDS service request topic '"
+                << service_name_ << "_Request'" << std::endl;
+
+        reply_default(pending);
+    }
+    else if (nullptr != early_reply)
+    {
+        deliver_reply(pending, early_reply);
+    }
+
+    for (const PendingRequest& oldest : evicted)
+    {
+        metrics_->dropped.fetch_add(1, std::memory_order_relaxed);
+
+        logger_ << utils::Logger::Level::WARN
+                << "Too many requests waiting for their reply for service '" << service_name_
+                << "', giving up the oldest one" << std::endl;
+
+        reply_default(oldest);
     }
 }
 
@@ -489,21 +647,21 @@ void Server::on_publication_matched(
         ::fastdds::dds::DataWriter* /*writer*/,
         const ::fastdds::dds::PublicationMatchedStatus& info)
 {
-    std::unique_lock<std::mutex> lock(matched_mtx_);
-    if (1 == info.current_count_change)
+    participant_->notify_event();
+
     {
-        pub_sub_matched_++;
-        if (2 == pub_sub_matched_)
-        {
-            mtx_.unlock();
-        }
+        std::unique_lock<std::mutex> lock(matched_mtx_);
+        request_matched_ = 0 < info.current_count;
+    }
+    matched_cv_.notify_all();
 
+    if (1 == info.current_count_change)
+    {
         logger_ << utils::Logger::Level::INFO
                 << "Publisher for topic '" << service_name_ << "_Request' matched" << std::endl;
     }
     else if (-1 == info.current_count_change)
     {
-        pub_sub_matched_--;
         logger_ << utils::Logger::Level::INFO
                 << "Publisher for topic '" << service_name_ << "_Request' unmatched" << std::endl;
     }
@@ -513,21 +671,21 @@ void Server::on_subscription_matched(
         ::fastdds::dds::DataReader* /*reader*/,
         const ::fastdds::dds::SubscriptionMatchedStatus& info)
 {
-    std::unique_lock<std::mutex> lock(matched_mtx_);
-    if (1 == info.current_count_change)
+    participant_->notify_event();
+
     {
-        pub_sub_matched_++;
-        if (2 == pub_sub_matched_)
-        {
-            mtx_.unlock();
-        }
+        std::unique_lock<std::mutex> lock(matched_mtx_);
+        reply_matched_ = 0 < info.current_count;
+    }
+    matched_cv_.notify_all();
 
+    if (1 == info.current_count_change)
+    {
         logger_ << utils::Logger::Level::INFO
                 << "Subscriber for topic '" << service_name_ << "_Reply' matched" << std::endl;
     }
     else if (-1 == info.current_count_change)
     {
-        pub_sub_matched_--;
         logger_ << utils::Logger::Level::INFO
                 << "Subscriber for topic '" << service_name_ << "_Reply' unmatched" << std::endl;
     }
@@ -536,166 +694,185 @@ void Server::on_subscription_matched(
 void Server::on_data_available(
         ::fastdds::dds::DataReader* /*reader*/)
 {
-    using namespace std::placeholders;
-
-    ::fastdds::dds::SampleInfo info;
+    // Drain the reader, handing each reply over to the reception pool
+    while (true)
+    {
+        ::fastdds::dds::SampleInfo info;
+        fastrtps::types::DynamicData* reply = taken_pool_.acquire();
 
-    std::unique_lock<std::mutex> lock(cleaner_mtx_);
-    reply_entities_.data_mtx.lock();
+        if (fastrtps::types::ReturnCode_t::RETCODE_OK
+                != reply_entities_.dds_datareader->take_next_sample(reply, &info))
+        {
+            taken_pool_.release(reply);
+            break;
+        }
 
-    if (!stop_cleaner_ && fastrtps::types::ReturnCode_t::RETCODE_OK
-            == reply_entities_.dds_datareader->take_next_sample(reply_entities_.dynamic_data, &info))
-    {
 #if FASTRTPS_VERSION_MINOR < 2
-        if (::fastdds::dds::InstanceStateKind::ALIVE == info.instance_state)
+        if (::fastdds::dds::InstanceStateKind::ALIVE != info.instance_state)
 #else
-        if (::fastdds::dds::InstanceStateKind::ALIVE_INSTANCE_STATE == info.instance_state)
+        if (::fastdds::dds::InstanceStateKind::ALIVE_INSTANCE_STATE != info.instance_state)
 #endif //  if FASTRTPS_VERSION_MINOR < 2
         {
-            logger_ << utils::Logger::Level::DEBUG
-                    << "Process incoming data available for service reply topic '"
-                    << service_name_ << "_Reply'" << std::endl;
-
-            std::thread* thread = new std::thread(&Server::receive, this, info.related_sample_identity);
-            reception_threads_.emplace(thread->get_id(), thread);
-        }
-        else
-        {
-            reply_entities_.data_mtx.unlock();
+            taken_pool_.release(reply);
+            continue;
         }
-    }
-    else
-    {
-        reply_entities_.data_mtx.unlock();
+
+        metrics_->samples_in.fetch_add(1, std::memory_order_relaxed);
+
+        logger_ << utils::Logger::Level::DEBUG
+                << "Process incoming data available for service reply topic '"
+                << service_name_ << "_Reply'" << std::endl;
+
+        // The reply is owned by the task from now on, or by the discard function if it is dropped
+        reception_pool_.push(
+            [this, reply, sample_id = info.related_sample_identity]()
+            {
+                metrics_->queue_depth.store(reception_pool_.pending(), std::memory_order_relaxed);
+                receive(reply, sample_id);
+            },
+            [this, reply]()
+            {
+                metrics_->dropped.fetch_add(1, std::memory_order_relaxed);
+                taken_pool_.release(reply);
+            });
+
+        metrics_->queue_depth.store(reception_pool_.pending(), std::memory_order_relaxed);
     }
 }
 
 void Server::receive(
+        fastrtps::types::DynamicData* reply,
         fastrtps::rtps::SampleIdentity sample_id)
 {
-    std::shared_ptr<void> call_handle;
+    PendingRequest request;
 
     {
         std::unique_lock<std::mutex> lock(mtx_);
-        if (sample_callhandle_.count(sample_id) > 0)
-        {
-            call_handle = sample_callhandle_[sample_id];
-        }
-        else
+        auto pending = pending_requests_.find(sample_id);
+        if (pending_requests_.end() == pending)
         {
+            // The reply may belong to a request whose write has not returned yet
+            if (0 < writes_in_flight_ && early_replies_.emplace(sample_id, reply).second)
+            {
+                return;
+            }
+
+            metrics_->dropped.fetch_add(1, std::memory_order_relaxed);
+
             logger_ << utils::Logger::Level::WARN
-                    << "Received reply from unasked request. Ignoring..." << std::endl;
-            reply_entities_.data_mtx.unlock();
+                    << "Received reply from unasked or expired request. Ignoring..." << std::endl;
+            taken_pool_.release(reply);
             return;
         }
+
+        request = std::move(pending->second);
+        pending_requests_.erase(pending);
     }
 
-    ::xtypes::DynamicData received(reply_entities_.type);
+    deliver_reply(request, reply);
+}
+
+void Server::deliver_reply(
+        const PendingRequest& request,
+        fastrtps::types::DynamicData* reply)
+{
+    ::xtypes::DynamicData* received = received_pool_.acquire();
 
     logger_ << utils::Logger::Level::INFO
             << "Receiving reply from DDS for service reply topic '"
             << service_name_ << "_Reply'" << std::endl;
 
-    bool success = Conversion::fastdds_to_xtypes(reply_entities_.dynamic_data, received);
-    reply_entities_.data_mtx.unlock();
+    bool success = Conversion::fastdds_to_xtypes(reply, *received);
+    taken_pool_.release(reply);
 
     if (success)
     {
-        std::unique_lock<std::mutex> lock(mtx_);
-        std::string path = reply_entities_.type.name();
-        if (reply_id_type_.count(sample_id) > 0)
-        {
-            path = type_to_discriminator_[reply_id_type_[sample_id]];
-            reply_id_type_.erase(sample_id);
-        }
-
-        ::xtypes::WritableDynamicDataRef ref = Conversion::access_member_data(received, path);
+        ::xtypes::WritableDynamicDataRef ref = Conversion::access_member_data(*received, *request.reply_path);
         ::xtypes::DynamicData message(ref, ref.type());
 
-        if (callhandle_client_.count(call_handle) > 0)
-        {
-            auto client = callhandle_client_.at(call_handle);
-            callhandle_client_.erase(call_handle);
-            sample_callhandle_.erase(sample_id);
+        request.client->receive_response(request.call_handle, message);
 
-            client->receive_response(
-                call_handle,
-                message);
-        }
-        else
-        {
-            logger_ << utils::Logger::Level::WARN
-                    << "Received reply from unasked request. Ignoring..." << std::endl;
-        }
+        metrics_->samples_out.fetch_add(1, std::memory_order_relaxed);
     }
     else
     {
+        metrics_->dropped.fetch_add(1, std::memory_order_relaxed);
+
         logger_ << utils::Logger::Level::ERROR
                 << "Failed to convert message from DDS to Integration Service "
                 << "for service reply topic '" << service_name_ << "_Reply'" << std::endl;
+
+        reply_default(request);
     }
 
-    // Notify that we have ended
-    std::unique_lock<std::mutex> lock(cleaner_mtx_);
-    finished_threads_.push_back(std::this_thread::get_id());
-    cleaner_cv_.notify_one();
+    received_pool_.release(received);
 }
 
-void Server::cleaner_function()
+void Server::expire_requests()
 {
-    using namespace std::chrono_literals;
-    std::unique_lock<std::mutex> lock(cleaner_mtx_);
-    std::vector<std::thread::id> stopped;
-
-    while (!stop_cleaner_)
+    if (0 == reply_timeout_.count())
     {
-        cleaner_cv_.wait(
-            lock,
-            [this]()
-            {
-                return stop_cleaner_ || !finished_threads_.empty();
-            });
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::vector<PendingRequest> expired;
 
-        for (std::thread::id id : finished_threads_)
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        while (!sent_requests_.empty() && sent_requests_.front().first + reply_timeout_ <= now)
         {
-            // Some threads may end too quickly, wait until the next iteration
-            if (reception_threads_.count(id) > 0)
+            // The request may have been replied already
+            auto pending = pending_requests_.find(sent_requests_.front().second);
+            if (pending_requests_.end() != pending)
             {
-                std::thread* thread = reception_threads_.at(id);
-                reception_threads_.erase(id);
-
-                if (thread->joinable())
-                {
-                    thread->join();
-                }
-                delete thread;
-                stopped.push_back(id);
+                expired.push_back(std::move(pending->second));
+                pending_requests_.erase(pending);
             }
+            sent_requests_.pop_front();
         }
+    }
 
-        for (std::thread::id id : stopped)
-        {
-            auto it = std::find(finished_threads_.begin(), finished_threads_.end(), id);
-            finished_threads_.erase(it);
-        }
-        stopped.clear();
+    for (const PendingRequest& request : expired)
+    {
+        metrics_->dropped.fetch_add(1, std::memory_order_relaxed);
+
+        logger_ << utils::Logger::Level::WARN
+                << "Request for service '" << service_name_ << "' timed out after "
+                << reply_timeout_.count() << " ms without reply" << std::endl;
 
-        // Free the CPU just a moment
-        lock.unlock();
-        std::this_thread::sleep_for(10ms);
-        lock.lock();
+        reply_default(request);
     }
+}
 
-    // Wait for the rest of threads
-    for (auto& pair : reception_threads_)
-    {
-        std::thread* thread = pair.second;
-        if (thread->joinable())
+void Server::reply_default(
+        const PendingRequest& request)
+{
+    ::xtypes::DynamicData reply(reply_entities_.type);
+    ::xtypes::WritableDynamicDataRef ref = Conversion::access_member_data(reply, *request.reply_path);
+    ::xtypes::DynamicData message(ref, ref.type());
+
+    request.client->receive_response(request.call_handle, message);
+}
+
+bool Server::wait_for_match()
+{
+    std::unique_lock<std::mutex> lock(matched_mtx_);
+    matched_cv_.wait(
+        lock,
+        [this]()
         {
-            thread->join();
-        }
-        delete thread;
-    }
+            return stopping_ || (request_matched_ && reply_matched_);
+        });
+
+    return !stopping_;
+}
+
+std::size_t Server::spin()
+{
+    expire_requests();
+
+    return reception_pool_.spin_driven() ? reception_pool_.run_pending() : 0;
 }
 
 } //  namespace fastdds
@@ -18,8 +18,11 @@
 #ifndef _IS_SH_FASTDDS__INTERNAL__SERVER_HPP_
 #define _IS_SH_FASTDDS__INTERNAL__SERVER_HPP_
 
+#include "Conversion.hpp"
 #include "DDSMiddlewareException.hpp"
+#include "ObjectPool.hpp"
 #include "Participant.hpp"
+#include "WorkerPool.hpp"
 
 #include <is/systemhandle/SystemHandle.hpp>
 #include <is/utils/Log.hpp>
@@ -27,8 +30,10 @@
 #include <fastdds/dds/publisher/Publisher.hpp>
 #include <fastdds/dds/subscriber/Subscriber.hpp>
 
-#include <thread>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <unordered_map>
 
 namespace fastdds = eprosima::fastdds;
 
@@ -66,7 +71,8 @@ class Participant;
  *        The request petitions are associated with each received reply by means of the
  *        <a href="https://fast-dds.docs.eprosima.com/en/latest/fastdds/api_reference/dds_pim/subscriber/sampleinfo.html?highlight=rpc#_CPPv4N8eprosima7fastdds3dds10SampleInfo15sample_identityE">
  *        sample identity</a> and the <a href="https://fast-dds.docs.eprosima.com/en/latest/fastdds/api_reference/dds_pim/subscriber/sampleinfo.html?highlight=rpc#_CPPv4N8eprosima7fastdds3dds10SampleInfo23related_sample_identityE">
- *        related sample identity</a> attributes.
+ *        related sample identity</a> attributes. The requests waiting for their reply are kept in
+ *        a bounded table, from which they expire after a configurable timeout.
  */
 class Server
     : public virtual ServiceProvider
@@ -75,6 +81,11 @@ class Server
 {
 public:
 
+    /**
+     * @brief Default maximum number of requests waiting for their reply.
+     */
+    static constexpr std::size_t DEFAULT_MAX_PENDING_REQUESTS = 1024;
+
     /**
      * @brief Construct a new Server object.
      *
@@ -89,6 +100,13 @@ public:
      * @param[in] reply_type A dynamic type definition of the reply topic's type.
      *
      * @param[in] config Additional configuration that might be required to configure this Server.
+     *            Allowed fields are:
+     *            - `reception`: Configuration of the WorkerPool in charge of processing the incoming replies.
+     *              Without worker threads, they are processed by spin().
+     *            - `reply_timeout_ms`: Time after which a request without reply expires. `0`, the default,
+     *              means that requests never expire.
+     *            - `max_pending_requests`: Maximum number of requests waiting for their reply.
+     *              When it is reached, the oldest request is given up to make room for the new one.
      *
      * @throws DDSMiddlewareExeption if some error occurs while creating the *Fast DDS* entities.
      */
@@ -150,6 +168,15 @@ public:
     bool add_config(
             const YAML::Node& configuration);
 
+    /**
+     * @brief Expire the requests whose reply timed out, and process, in the calling thread,
+     *        the replies waiting in the reception queue.
+     *        Only spin-driven servers, configured with `reception: { threads: 0 }`, process replies here.
+     *
+     * @returns The number of processed replies.
+     */
+    std::size_t spin();
+
 private:
 
     /**
@@ -176,16 +203,56 @@ private:
      * @brief Receive a DDS service response, for the provided SampleIdentity.
      *        If the sample_id does not correspond to a previously made petition, it is ignored.
      *
+     * @param[in] reply The reply taken from the datareader, which is released afterwards.
+     *
      * @param[in] sample_id The sample identity that identifies the answered request.
      */
     void receive(
+            fastrtps::types::DynamicData* reply,
             fastrtps::rtps::SampleIdentity sample_id);
 
     /**
-     * @brief Function to look for threads that have already finished and delete them from the
-     *        reception threads database.
+     * @brief A request sent to DDS, waiting for its reply.
+     */
+    struct PendingRequest
+    {
+        std::shared_ptr<void> call_handle;
+        ServiceClient* client;
+        const MemberPath* reply_path;
+    };
+
+    /**
+     * @brief Convert a DDS service reply and hand it over to the client of its request.
+     *
+     * @param[in] request The request answered by the reply.
+     *
+     * @param[in] reply The reply taken from the datareader, which is released afterwards.
+     */
+    void deliver_reply(
+            const PendingRequest& request,
+            fastrtps::types::DynamicData* reply);
+
+    /**
+     * @brief Remove the requests whose reply timeout has elapsed, reporting them to their clients.
+     */
+    void expire_requests();
+
+    /**
+     * @brief Report to the *Integration Service* client that a request will not be replied,
+     *        by answering it with a default reply, as the client has no other way to be told.
+     *
+     * @param[in] request The request given up.
+     */
+    void reply_default(
+            const PendingRequest& request);
+
+    /**
+     * @brief Wait until both the request datawriter and the reply datareader are matched,
+     *        so that the requests are not lost.
+     *
+     * @returns `false` if the Server is being destroyed.
      */
-    void cleaner_function();
+    bool wait_for_match();
 
     /**
      * Class members.
@@ -221,65 +288,88 @@ private:
             : dds_subscriber(nullptr)
             , dds_topic(nullptr)
             , dds_datareader(nullptr)
-            , dynamic_data(nullptr)
             , type(dynamic_type)
-            , data_mtx()
         {
         }
 
         ::fastdds::dds::Subscriber* dds_subscriber;
         ::fastdds::dds::Topic* dds_topic;
         ::fastdds::dds::DataReader* dds_datareader;
-        fastrtps::types::DynamicData* dynamic_data;
         const xtypes::DynamicType& type;
-        std::mutex data_mtx;
     };
     ReplyEntities reply_entities_;
 
-    struct SampleIdentityComparator
+    /**
+     * Pool of the *xtypes* replys received from DDS.
+     * They are only kept for reuse if the type contains no sequences nor maps.
+     */
+    ObjectPool<::xtypes::DynamicData> received_pool_;
+
+    /**
+     * Pool of the *Fast DDS* replies taken from the datareader, handed over to the reception workers.
+     */
+    ObjectPool<fastrtps::types::DynamicData> taken_pool_;
+
+    struct SampleIdentityHash
     {
-        bool operator () (
-                const fastrtps::rtps::SampleIdentity lha,
-                const fastrtps::rtps::SampleIdentity rha) const
+        std::size_t operator () (
+                const fastrtps::rtps::SampleIdentity& sample_id) const
         {
-            if (lha.writer_guid() < rha.writer_guid())
+            // The sequence number tells apart the requests of the same writer, so it is mixed in last
+            std::size_t hash = 0;
+            for (fastrtps::rtps::octet byte : sample_id.writer_guid().guidPrefix.value)
             {
-                return true;
+                hash = hash * 31 + byte;
             }
-            if (rha.writer_guid() < lha.writer_guid()) // operator > doesn't exists for GUID_t
+            for (fastrtps::rtps::octet byte : sample_id.writer_guid().entityId.value)
             {
-                return false;
+                hash = hash * 31 + byte;
             }
-            if (lha.sequence_number() < rha.sequence_number())
-            {
-                return true;
-            }
-            return false;
+            return hash ^ std::hash<uint64_t>()(sample_id.sequence_number().to64long());
         }
 
     };
 
-    std::map<std::shared_ptr<void>, ServiceClient*> callhandle_client_;
-    std::map<fastrtps::rtps::SampleIdentity,
-            std::shared_ptr<void>, SampleIdentityComparator> sample_callhandle_;
-    std::map<std::string, std::string> type_to_discriminator_;
-    std::map<std::string, std::string> request_reply_;
-    std::map<fastrtps::rtps::SampleIdentity,
-            std::string, SampleIdentityComparator> reply_id_type_;
+    /**
+     * Members of the request and reply types that hold each configured request type, by its name.
+     * The requests of types not configured are the whole request, and get the whole reply.
+     */
+    std::unordered_map<std::string, MemberPath> request_paths_;
+    std::unordered_map<std::string, MemberPath> reply_paths_;
+    const MemberPath root_path_;
+
+    std::unordered_map<fastrtps::rtps::SampleIdentity, PendingRequest, SampleIdentityHash> pending_requests_;
+
+    /**
+     * Sending time of each request, in the order they were sent, to expire or evict the oldest ones.
+     * The replied requests are skipped when they reach the front, or removed when they pile up.
+     */
+    using SentRequest = std::pair<std::chrono::steady_clock::time_point, fastrtps::rtps::SampleIdentity>;
+    std::deque<SentRequest> sent_requests_;
+    std::chrono::milliseconds reply_timeout_;
+    std::size_t max_pending_requests_;
+
+    /**
+     * Replies received while some request is being written, which may belong to it.
+     * They are given up once no request is being written.
+     */
+    std::size_t writes_in_flight_;
+    std::unordered_map<fastrtps::rtps::SampleIdentity, fastrtps::types::DynamicData*,
+            SampleIdentityHash> early_replies_;
 
     std::mutex mtx_;
 
     std::mutex matched_mtx_;
-    uint8_t pub_sub_matched_;
+    std::condition_variable matched_cv_;
+    bool request_matched_;
+    bool reply_matched_;
+    bool stopping_;
 
-    std::map<std::thread::id, std::thread*> reception_threads_;
-    bool stop_cleaner_;
-    std::vector<std::thread::id> finished_threads_;
-    std::mutex cleaner_mtx_;
-    std::condition_variable cleaner_cv_;
-    std::thread cleaner_thread_;
+    std::shared_ptr<TopicMetrics> metrics_;
 
     utils::Logger logger_;
+
+    WorkerPool reception_pool_;
 };
 
 } //  namespace fastdds
@@ -17,6 +17,7 @@
 
 #include "Subscriber.hpp"
 #include "Conversion.hpp"
+#include "QosConfiguration.hpp"
 
 #include <is/core/Message.hpp>
 
@@ -27,42 +28,129 @@
 #include <fastdds/dds/subscriber/InstanceState.hpp>
 #endif //  if FASTRTPS_VERSION_MINOR >= 2
 
+#include <algorithm>
+#include <chrono>
 #include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace eprosima {
 namespace is {
 namespace sh {
 namespace fastdds {
 
+constexpr std::size_t Subscriber::MAX_BATCH_SIZE;
+
+namespace {
+
+bool is_alive(
+        const ::fastdds::dds::SampleInfo& info)
+{
+#if FASTRTPS_VERSION_MINOR < 2
+    return ::fastdds::dds::InstanceStateKind::ALIVE == info.instance_state;
+#else
+    return ::fastdds::dds::InstanceStateKind::ALIVE_INSTANCE_STATE == info.instance_state;
+#endif //  if FASTRTPS_VERSION_MINOR < 2
+}
+
+} //  anonymous namespace
+
 Subscriber::Subscriber(
         Participant* participant,
         const std::string& topic_name,
         const xtypes::DynamicType& message_type,
-        TopicSubscriberSystem::SubscriptionCallback* is_callback)
+        TopicSubscriberSystem::SubscriptionCallback* is_callback,
+        const YAML::Node& config)
     : participant_(participant)
     , dds_subscriber_(nullptr)
-    , dynamic_data_(nullptr)
     , topic_name_(topic_name)
     , message_type_(message_type)
+    , direct_serialization_(false)
+    , reusable_samples_(Conversion::is_reusable(message_type))
+    , message_pool_(
+        [&message_type]()
+        {
+            return new ::xtypes::DynamicData(message_type);
+        },
+        [](::xtypes::DynamicData* data)
+        {
+            delete data;
+        },
+        reusable_samples_ ? 2 * MAX_BATCH_SIZE : 0)
+    , taken_pool_(
+        [this]()
+        {
+            return static_cast<fastrtps::types::DynamicData*>(type_support_.create_data());
+        },
+        [this](fastrtps::types::DynamicData* data)
+        {
+            type_support_.delete_data(data);
+        },
+        reusable_samples_ ? 2 * MAX_BATCH_SIZE : 0)
     , is_callback_(is_callback)
-    , reception_threads_()
-    , stop_cleaner_(false)
-    , cleaner_thread_(&Subscriber::cleaner_function, this)
+    , metrics_(participant->metrics().topic("subscriber", topic_name))
     , logger_("is::sh::FastDDS::Subscriber")
+    , reception_pool_(
+        topic_name,
+        config["reception"],
+        [participant]()
+        {
+            participant->notify_event();
+        })
 {
-    DynamicTypeBuilder* builder = Conversion::create_builder(message_type);
-    if (builder != nullptr)
+    uint32_t log_sampling = LogSampler::DEFAULT_ONE_IN;
+
+    try
     {
-        participant->register_dynamic_type(topic_name, message_type.name(), builder);
+        if (config["direct_serialization"])
+        {
+            direct_serialization_ = config["direct_serialization"].as<bool>();
+        }
+
+        if (config["log_sampling"])
+        {
+            log_sampling = config["log_sampling"].as<uint32_t>();
+        }
     }
-    else
+    catch (const YAML::Exception& e)
+    {
+        std::ostringstream err;
+        err << "Invalid configuration for topic '" << topic_name << "': " << e.what();
+
+        throw DDSMiddlewareException(logger_, err.str());
+    }
+
+    if (0 == log_sampling)
+    {
+        std::ostringstream err;
+        err << "Invalid configuration for topic '" << topic_name
+            << "': 'log_sampling' must be greater than zero";
+
+        throw DDSMiddlewareException(logger_, err.str());
+    }
+    message_log_.one_in(log_sampling);
+
+    DynamicTypeBuilder* builder = Conversion::create_builder(message_type);
+    if (builder == nullptr)
     {
         throw DDSMiddlewareException(
                   logger_, "Cannot create builder for type " + message_type.name());
     }
 
-    dynamic_data_ = participant->create_dynamic_data(topic_name);
+    if (direct_serialization_)
+    {
+        participant->register_xtypes_type(topic_name, message_type, builder);
+    }
+    else
+    {
+        participant->register_dynamic_type(topic_name, message_type.name(), builder);
+
+        // Build the decoding plan now, so that the first received sample does not pay for it
+        Conversion::prepare_plan(message_type);
+    }
 
     // Retrieve DDS participant
     ::fastdds::dds::DomainParticipant* dds_participant = participant->get_dds_participant();
@@ -72,6 +160,11 @@ Subscriber::Subscriber(
                   logger_, "Trying to create a subscriber without a DDS participant!");
     }
 
+    // The registered type support creates the samples to be taken from the datareader
+    type_support_ = dds_participant->find_type(message_type.name());
+
+    local_prefix_ = dds_participant->guid().guidPrefix;
+
     // Create DDS subscriber with default subscriber QoS
     dds_subscriber_ = dds_participant->create_subscriber(::fastdds::dds::SUBSCRIBER_QOS_DEFAULT);
 
@@ -116,10 +209,16 @@ Subscriber::Subscriber(
 
     // Create DDS datareader
     ::fastdds::dds::DataReaderQos datareader_qos = ::fastdds::dds::DATAREADER_QOS_DEFAULT;
+    participant_->configure_data_sharing(datareader_qos, dds_topic_);
     ::fastdds::dds::ReliabilityQosPolicy rel_policy;
     rel_policy.kind = ::fastdds::dds::RELIABLE_RELIABILITY_QOS;
     datareader_qos.reliability(rel_policy);
 
+    if (config["qos"])
+    {
+        QosConfiguration::apply(config["qos"], topic_name, datareader_qos);
+    }
+
     dds_datareader_ = dds_subscriber_->create_datareader(dds_topic_, datareader_qos, this);
     if (dds_datareader_)
     {
@@ -142,26 +241,14 @@ Subscriber::~Subscriber()
     logger_ << utils::Logger::Level::INFO
             << "Waiting for current processing messages before quitting" << std::endl;
 
-    {
-        std::unique_lock<std::mutex> lock(cleaner_mtx_);
-        stop_cleaner_ = true;
-        cleaner_cv_.notify_one();
-    }
-
-    if (cleaner_thread_.joinable())
-    {
-        cleaner_thread_.join();
-    }
+    dds_datareader_->set_listener(nullptr);
+    reception_pool_.stop();
 
     logger_ << utils::Logger::Level::INFO
             << "All messages were processed. Quitting now..." << std::endl;
 
-    std::unique_lock<std::mutex> lock(data_mtx_);
-    participant_->delete_dynamic_data(dynamic_data_);
-
     bool delete_topic = participant_->dissociate_topic_from_dds_entity(dds_topic_, dds_datareader_);
 
-    dds_datareader_->set_listener(nullptr);
     dds_subscriber_->delete_datareader(dds_datareader_);
     participant_->get_dds_participant()->delete_subscriber(dds_subscriber_);
 
@@ -175,73 +262,215 @@ void Subscriber::receive(
         const fastrtps::types::DynamicData* dds_message,
         ::fastdds::dds::SampleInfo sample_info)
 {
-    logger_ << utils::Logger::Level::INFO
-            << "Receiving message from DDS for topic '" << topic_name_ << "'" << std::endl;
+    ::xtypes::DynamicData* is_message = message_pool_.acquire();
 
-    ::xtypes::DynamicData is_message(message_type_);
-    bool success = Conversion::fastdds_to_xtypes(dds_message, is_message);
-    data_mtx_.unlock();
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool success = Conversion::fastdds_to_xtypes(dds_message, *is_message);
+    metrics_->conversion.record(std::chrono::steady_clock::now() - start);
 
     if (success)
     {
-        logger_ << utils::Logger::Level::INFO
-                << "Received message: [[ " << is_message << " ]]" << std::endl;
-
-        (*is_callback_)(is_message, static_cast<void*>(&sample_info));
+        receive(*is_message, sample_info);
     }
     else
     {
+        metrics_->dropped.fetch_add(1, std::memory_order_relaxed);
+
         logger_ << utils::Logger::Level::ERROR
                 << "Failed to convert message from DDS to Integration Service for topic '"
                 << topic_name_ << "'" << std::endl;
     }
 
-    // Notify that we have ended
-    std::unique_lock<std::mutex> lock(cleaner_mtx_);
-    finished_threads_.push_back(std::this_thread::get_id());
-    cleaner_cv_.notify_one();
+    message_pool_.release(is_message);
 }
 
-void Subscriber::on_data_available(
-        ::fastdds::dds::DataReader* /*reader*/)
+void Subscriber::receive(
+        const ::xtypes::DynamicData& is_message,
+        ::fastdds::dds::SampleInfo sample_info)
 {
-    using namespace std::placeholders;
+    // Printing the message may cost more than converting it, so only do it when it is going to be shown
+    if (message_log_.enabled(logger_, utils::Logger::Level::INFO))
+    {
+        logger_ << utils::Logger::Level::INFO
+                << "Received message from DDS for topic '" << topic_name_ << "': [[ "
+                << is_message << " ]]" << std::endl;
+    }
 
-    ::fastdds::dds::SampleInfo info;
-    std::unique_lock<std::mutex> lock(cleaner_mtx_);
-    data_mtx_.lock();
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    (*is_callback_)(is_message, static_cast<void*>(&sample_info));
+    metrics_->delivery.record(std::chrono::steady_clock::now() - start);
 
-    if (!stop_cleaner_ && fastrtps::types::ReturnCode_t::RETCODE_OK
-            == dds_datareader_->take_next_sample(dynamic_data_, &info))
+    metrics_->samples_out.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Subscriber::on_data_available(
+        ::fastdds::dds::DataReader* /*reader*/)
+{
+    // Keeping the last sample of each instance needs each of them in its own task, so that it can be replaced
+    const bool keep_last =
+            WorkerPool::OverflowPolicy::KEEP_LAST_PER_INSTANCE == reception_pool_.overflow_policy();
+    const std::size_t batch_size = keep_last ? 1 : MAX_BATCH_SIZE;
+
+    // The samples of keyed topics are batched per instance, so that the pool keeps the order of each
+    // instance while processing different ones in parallel
+    const bool per_instance = keep_last || type_support_->m_isGetKeyDefined;
+
+    // Batches being filled, each one with the instance of its samples
+    std::vector<std::pair<std::string, std::shared_ptr<Batch> > > batches;
+
+    // Drain the reader, handing the samples over to the reception pool in batches.
+    // A sample which is not handed over is reused for the next take, unless its type has
+    // sequences or maps, which would keep the elements of the discarded sample.
+    void* sample = nullptr;
+    bool drained = false;
+    while (!drained)
     {
-#if FASTRTPS_VERSION_MINOR < 2
-        if (::fastdds::dds::InstanceStateKind::ALIVE == info.instance_state)
-#else
-        if (::fastdds::dds::InstanceStateKind::ALIVE_INSTANCE_STATE == info.instance_state)
-#endif //  if FASTRTPS_VERSION_MINOR < 2
+        ::fastdds::dds::SampleInfo info;
+        if (nullptr == sample)
         {
-            logger_ << utils::Logger::Level::DEBUG
-                    << "Processing incoming data available for topic '"
-                    << topic_name_ << "'" << std::endl;
+            sample = create_sample();
+        }
 
-            std::thread* thread = new std::thread(&Subscriber::receive, this, dynamic_data_, info);
-            reception_threads_.emplace(thread->get_id(), thread);
+        if (fastrtps::types::ReturnCode_t::RETCODE_OK
+                != dds_datareader_->take_next_sample(sample, &info))
+        {
+            delete_sample(sample);
+            drained = true;
         }
-        else
+        else if (is_alive(info) && !is_local_sample(info))
+        {
+            metrics_->samples_in.fetch_add(1, std::memory_order_relaxed);
+
+            // Samples of keyless topics all share the same instance handle
+            std::string instance;
+            if (per_instance)
+            {
+                instance.assign(reinterpret_cast<const char*>(info.instance_handle.value),
+                        sizeof(info.instance_handle.value));
+            }
+
+            auto batch = std::find_if(batches.begin(), batches.end(), [&instance](const auto& open_batch)
+                            {
+                                return open_batch.first == instance;
+                            });
+            if (batches.end() == batch)
+            {
+                batches.emplace_back(std::move(instance), std::make_shared<Batch>());
+                batch = std::prev(batches.end());
+                batch->second->reserve(batch_size);
+            }
+            batch->second->emplace_back(sample, info);
+            sample = nullptr;
+
+            if (batch->second->size() >= batch_size)
+            {
+                dispatch(batch->first, batch->second);
+                batches.erase(batch);
+            }
+        }
+        else if (!reusable_samples_)
+        {
+            delete_sample(sample);
+            sample = nullptr;
+        }
+
+        // Do not hold many samples back when they belong to many instances
+        if (drained || batches.size() >= MAX_BATCH_SIZE)
         {
-            data_mtx_.unlock();
+            for (const auto& open_batch : batches)
+            {
+                dispatch(open_batch.first, open_batch.second);
+            }
+            batches.clear();
         }
     }
+}
+
+void Subscriber::dispatch(
+        const std::string& instance,
+        const std::shared_ptr<Batch>& batch)
+{
+    logger_ << utils::Logger::Level::DEBUG
+            << "Processing " << batch->size() << " incoming samples for topic '"
+            << topic_name_ << "'" << std::endl;
+
+    // The samples are owned by the task from now on, or by the discard function if the
+    // overflow policy drops them; blocks while the reception queue is full, if so configured
+    reception_pool_.push(
+        [this, batch]()
+        {
+            metrics_->queue_depth.store(reception_pool_.pending(), std::memory_order_relaxed);
+
+            for (const auto& sample : *batch)
+            {
+                if (direct_serialization_)
+                {
+                    receive(*static_cast<const ::xtypes::DynamicData*>(sample.first), sample.second);
+                }
+                else
+                {
+                    receive(static_cast<const fastrtps::types::DynamicData*>(sample.first), sample.second);
+                }
+
+                delete_sample(sample.first);
+            }
+        },
+        [this, batch]()
+        {
+            metrics_->dropped.fetch_add(batch->size(), std::memory_order_relaxed);
+
+            for (const auto& sample : *batch)
+            {
+                delete_sample(sample.first);
+            }
+        },
+        instance);
+
+    metrics_->queue_depth.store(reception_pool_.pending(), std::memory_order_relaxed);
+}
+
+bool Subscriber::is_local_sample(
+        const ::fastdds::dds::SampleInfo& info) const
+{
+    // Samples published by Integration Service itself would be discarded by the core
+    // after being converted, so they are dropped before
+    return local_prefix_ == fastrtps::rtps::iHandle2GUID(info.publication_handle).guidPrefix;
+}
+
+void* Subscriber::create_sample()
+{
+    if (direct_serialization_)
+    {
+        return message_pool_.acquire();
+    }
+
+    return taken_pool_.acquire();
+}
+
+void Subscriber::delete_sample(
+        void* sample)
+{
+    if (direct_serialization_)
+    {
+        message_pool_.release(static_cast<::xtypes::DynamicData*>(sample));
+    }
     else
     {
-        data_mtx_.unlock();
+        taken_pool_.release(static_cast<fastrtps::types::DynamicData*>(sample));
     }
 }
 
+std::size_t Subscriber::spin()
+{
+    return reception_pool_.spin_driven() ? reception_pool_.run_pending() : 0;
+}
+
 void Subscriber::on_subscription_matched(
         ::fastdds::dds::DataReader* /*reader*/,
         const ::fastdds::dds::SubscriptionMatchedStatus& info)
 {
+    participant_->notify_event();
+
     if (1 == info.current_count_change)
     {
         logger_ << utils::Logger::Level::INFO
@@ -254,63 +483,6 @@ void Subscriber::on_subscription_matched(
     }
 }
 
-void Subscriber::cleaner_function()
-{
-    using namespace std::chrono_literals;
-    std::unique_lock<std::mutex> lock(cleaner_mtx_);
-    std::vector<std::thread::id> stopped;
-
-    while (!stop_cleaner_)
-    {
-        cleaner_cv_.wait(
-            lock,
-            [this]()
-            {
-                return stop_cleaner_ || !finished_threads_.empty();
-            });
-
-        for (std::thread::id id : finished_threads_)
-        {
-            // Some threads may end too quickly, wait until the next iteration
-            if (reception_threads_.count(id) > 0)
-            {
-                std::thread* thread = reception_threads_.at(id);
-                reception_threads_.erase(id);
-
-                if (thread->joinable())
-                {
-                    thread->join();
-                }
-                delete thread;
-                stopped.push_back(id);
-            }
-        }
-
-        for (std::thread::id id : stopped)
-        {
-            auto it = std::find(finished_threads_.begin(), finished_threads_.end(), id);
-            finished_threads_.erase(it);
-        }
-        stopped.clear();
-
-        // Free the CPU just a moment
-        lock.unlock();
-        std::this_thread::sleep_for(10ms);
-        lock.lock();
-    }
-
-    // Wait for the rest of threads
-    for (auto& pair : reception_threads_)
-    {
-        std::thread* thread = pair.second;
-        if (thread->joinable())
-        {
-            thread->join();
-        }
-        delete thread;
-    }
-}
-
 } // namespace fastdds
 } // namespace sh
 } // namespace is
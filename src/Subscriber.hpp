@@ -19,16 +19,22 @@
 #define _IS_SH_FASTDDS__INTERNAL__SUBSCRIBER_HPP_
 
 #include "DDSMiddlewareException.hpp"
+#include "LogSampler.hpp"
+#include "ObjectPool.hpp"
 #include "Participant.hpp"
+#include "WorkerPool.hpp"
 
 #include <is/systemhandle/SystemHandle.hpp>
 #include <is/utils/Log.hpp>
 
 #include <fastdds/dds/subscriber/Subscriber.hpp>
 #include <fastdds/dds/subscriber/SampleInfo.hpp>
+#include <fastdds/dds/topic/TypeSupport.hpp>
 
-#include <thread>
-#include <condition_variable>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace fastdds = eprosima::fastdds;
 
@@ -61,6 +67,11 @@ class Subscriber : private ::fastdds::dds::DataReaderListener
 {
 public:
 
+    /**
+     * @brief Maximum number of samples handed over to the reception pool as a single task.
+     */
+    static constexpr std::size_t MAX_BATCH_SIZE = 32;
+
     /**
      * @brief Construct a new Subscriber object.
      *
@@ -74,13 +85,22 @@ public:
      * @param[in] is_callback Callback function signature defined by the *Integration Service*,
      *            triggered each time a new data arrives to the DDS Subscriber.
      *
+     * @param[in] config The topic configuration. Allowed fields are:
+     *            - `reception`: Configuration of the WorkerPool in charge of processing the incoming samples.
+     *              Without worker threads, the samples are processed by spin().
+     *            - `direct_serialization`: If `true`, the incoming samples are deserialized straight into
+     *              their *xtypes* representation, without building a *Fast DDS* DynamicData.
+     *            - `log_sampling`: Only log the contents of one out of every `log_sampling` messages.
+     *            - `qos`: QoS of the datareader, as described in QosConfiguration.
+     *
      * @throws DDSMiddlewareException if some error occurs while creating the *Fast DDS* subscriber.
      */
     Subscriber(
             Participant* participant,
             const std::string& topic_name,
             const xtypes::DynamicType& message_type,
-            TopicSubscriberSystem::SubscriptionCallback* is_callback);
+            TopicSubscriberSystem::SubscriptionCallback* is_callback,
+            const YAML::Node& config);
 
     // TODO(@jamoralp): Create subscriber based on XML profiles?
 
@@ -124,14 +144,76 @@ public:
             const fastrtps::types::DynamicData* dds_message,
             ::fastdds::dds::SampleInfo sample_info);
 
+    /**
+     * @brief Forward a message, already in its *xtypes* representation, to the *Integration Service*.
+     *
+     * @param[in] is_message The incoming message.
+     *
+     * @param[in] sample_info Structure containing the relevant information regarding the incoming message.
+     */
+    void receive(
+            const xtypes::DynamicData& is_message,
+            ::fastdds::dds::SampleInfo sample_info);
+
+    /**
+     * @brief Process, in the calling thread, the samples waiting in the reception queue.
+     *        Only spin-driven subscribers, configured with `reception: { threads: 0 }`, are affected.
+     *
+     * @returns The number of processed batches.
+     */
+    std::size_t spin();
+
 private:
 
+    /**
+     * @brief Samples taken from the datareader, along with their information.
+     */
+    using Batch = std::vector<std::pair<void*, ::fastdds::dds::SampleInfo> >;
+
+    /**
+     * @brief Check whether a sample was published by an entity of this same *Integration Service* participant.
+     *
+     * @param[in] info The information of the sample.
+     *
+     * @returns `true` if the sample comes from a local datawriter.
+     */
+    bool is_local_sample(
+            const ::fastdds::dds::SampleInfo& info) const;
+
+    /**
+     * @brief Get an empty sample to take from the datareader. In direct serialization mode,
+     *        it is an *xtypes* DynamicData taken from the message pool, and otherwise a *Fast DDS*
+     *        DynamicData taken from the taken pool.
+     */
+    void* create_sample();
+
+    /**
+     * @brief Release a sample obtained from create_sample().
+     */
+    void delete_sample(
+            void* sample);
+
     /**
      * @brief Inherited from *DataReaderListener*.
+     *
+     *        All the available samples are taken, and handed over to the reception pool
+     *        in batches of up to MAX_BATCH_SIZE samples. For keyed topics, each batch only
+     *        holds samples of the same instance.
      */
     void on_data_available(
             ::fastdds::dds::DataReader* /*reader*/) override;
 
+    /**
+     * @brief Hand a batch of samples over to the reception pool.
+     *
+     * @param[in] instance The instance of the samples, or empty if they are not ordered per instance.
+     *
+     * @param[in] batch The samples, released once processed or dropped.
+     */
+    void dispatch(
+            const std::string& instance,
+            const std::shared_ptr<Batch>& batch);
+
     /**
      * @brief Inherited from *DataReaderListener*.
      */
@@ -139,12 +221,6 @@ private:
             ::fastdds::dds::DataReader* reader,
             const ::fastdds::dds::SubscriptionMatchedStatus& info) override;
 
-    /**
-     * @brief Function to look for threads that have already finished and delete them from the
-     *        reception threads database.
-     */
-    void cleaner_function();
-
     /**
      * Class members.
      */
@@ -152,23 +228,33 @@ private:
     ::fastdds::dds::Subscriber* dds_subscriber_;
     ::fastdds::dds::Topic* dds_topic_;
     ::fastdds::dds::DataReader* dds_datareader_;
-
-    fastrtps::types::DynamicData* dynamic_data_;
-    std::mutex data_mtx_;
+    ::fastdds::dds::TypeSupport type_support_;
+    fastrtps::rtps::GuidPrefix_t local_prefix_;
 
     const std::string topic_name_;
     const xtypes::DynamicType& message_type_;
+    bool direct_serialization_;
+    const bool reusable_samples_;
 
-    TopicSubscriberSystem::SubscriptionCallback* is_callback_;
+    /**
+     * Pool of the *xtypes* messages handed over to the *Integration Service*.
+     * They are only kept for reuse if the type contains no sequences nor maps.
+     */
+    ObjectPool<::xtypes::DynamicData> message_pool_;
+
+    /**
+     * Pool of the *Fast DDS* samples taken from the datareader, handed over to the reception workers.
+     * They are only kept for reuse under the same condition.
+     */
+    ObjectPool<fastrtps::types::DynamicData> taken_pool_;
 
-    std::map<std::thread::id, std::thread*> reception_threads_;
-    bool stop_cleaner_;
-    std::vector<std::thread::id> finished_threads_;
-    std::mutex cleaner_mtx_;
-    std::condition_variable cleaner_cv_;
-    std::thread cleaner_thread_;
+    TopicSubscriberSystem::SubscriptionCallback* is_callback_;
+    std::shared_ptr<TopicMetrics> metrics_;
 
     utils::Logger logger_;
+    LogSampler message_log_;
+
+    WorkerPool reception_pool_;
 };
 
 } //  namespace fastdds
@@ -15,9 +15,7 @@
  *
  */
 
-#include <is/systemhandle/SystemHandle.hpp>
-#include <is/utils/Log.hpp>
-
+#include "SystemHandle.hpp"
 #include "Participant.hpp"
 #include "Publisher.hpp"
 #include "Subscriber.hpp"
@@ -33,268 +31,282 @@ namespace is {
 namespace sh {
 namespace fastdds {
 
-/**
- * @class SystemHandle
- *        This class represents a full *Integration Service* system handle or plugin for the *DDS*
- *        middleware, using eProsima's implementation, <a href="https://fast-dds.docs.eprosima.com/en/latest/">
- *        Fast DDS</a>.
- *
- *        This class inherits from is::FullSystem, so to implement publisher, subscriber, and server/
- *        client operations for the *Integration Service*.
- *
- */
-class SystemHandle : public virtual FullSystem
+SystemHandle::SystemHandle()
+    : FullSystem()
+    , logger_("is::sh::FastDDS")
 {
-public:
-
-    SystemHandle()
-        : FullSystem()
-        , logger_("is::sh::FastDDS")
-    {
-    }
+}
 
-    ~SystemHandle()
+SystemHandle::~SystemHandle()
+{
+    if (metrics_reporter_)
     {
+        metrics_reporter_->dump();
     }
+}
 
-    bool configure(
-            const core::RequiredTypes& /*types*/,
-            const YAML::Node& configuration,
-            TypeRegistry& /*type_registry*/) override
+bool SystemHandle::configure(
+        const core::RequiredTypes& /*types*/,
+        const YAML::Node& configuration,
+        TypeRegistry& /*type_registry*/)
+{
+    /*
+     * The Fast-DDS sh doesn't define new types.
+     * Needed types will be defined in the 'types' section of the YAML file, and hence,
+     * already registered in the 'TypeRegistry' by the *Integration Service core*.
+     */
+    try
     {
-        /*
-         * The Fast-DDS sh doesn't define new types.
-         * Needed types will be defined in the 'types' section of the YAML file, and hence,
-         * already registered in the 'TypeRegistry' by the *Integration Service core*.
-         */
-        try
+        if (configuration["participant"])
         {
-            if (configuration["participant"])
-            {
-                participant_ = std::make_unique<Participant>(configuration["participant"]);
-            }
-            else
-            {
-                logger_ << utils::Logger::Level::WARN
-                        << "Participant not provided in configuration file. "
-                        << "A participant using the default transport locators "
-                        << "and Domain ID 0 will be created." << std::endl;
+            participant_ = std::make_unique<Participant>(configuration["participant"]);
+        }
+        else
+        {
+            logger_ << utils::Logger::Level::WARN
+                    << "Participant not provided in configuration file. "
+                    << "A participant using the default transport locators "
+                    << "and Domain ID 0 will be created." << std::endl;
 
-                participant_ = std::make_unique<Participant>();
-            }
+            participant_ = std::make_unique<Participant>();
         }
-        catch (DDSMiddlewareException& e)
+
+        if (configuration["metrics"])
         {
-            e.from_logger << utils::Logger::Level::ERROR << e.what() << std::endl;
-            return false;
+            metrics_reporter_ = std::make_unique<MetricsReporter>(
+                participant_->metrics(), configuration["metrics"]);
         }
+    }
+    catch (DDSMiddlewareException& e)
+    {
+        e.from_logger << utils::Logger::Level::ERROR << e.what() << std::endl;
+        return false;
+    }
 
-        logger_ << utils::Logger::Level::INFO << "Configured!" << std::endl;
+    logger_ << utils::Logger::Level::INFO << "Configured!" << std::endl;
 
-        return true;
+    return true;
+}
+
+bool SystemHandle::okay() const
+{
+    return (nullptr != participant_->get_dds_participant());
+}
+
+bool SystemHandle::spin_once()
+{
+    using namespace std::chrono_literals;
+
+    // Return as soon as something happens on the DDS entities, without blocking the core for long
+    participant_->wait_for_event(100ms);
+
+    // Process the samples of the spin-driven subscribers, clients and servers
+    for (const std::shared_ptr<Subscriber>& subscriber : subscribers_)
+    {
+        subscriber->spin();
     }
 
-    bool okay() const override
+    for (const auto& client : clients_)
     {
-        return (nullptr != participant_->get_dds_participant());
+        client.second->spin();
     }
 
-    bool spin_once() override
+    for (const auto& server : servers_)
     {
-        using namespace std::chrono_literals;
-        std::this_thread::sleep_for(100ms);
-        return okay();
+        server.second->spin();
     }
 
-    bool subscribe(
-            const std::string& topic_name,
-            const xtypes::DynamicType& message_type,
-            SubscriptionCallback* callback,
-            const YAML::Node& /* configuration */) override
+    if (metrics_reporter_)
     {
-        try
-        {
-            auto subscriber = std::make_shared<Subscriber>(
-                participant_.get(), topic_name, message_type, callback);
+        metrics_reporter_->update();
+    }
 
-            subscribers_.emplace_back(std::move(subscriber));
+    return okay();
+}
 
-            logger_ << utils::Logger::Level::INFO
-                    << "Subscriber created for topic '" << topic_name << "', with type '"
-                    << message_type.name() << "'" << std::endl;
+std::vector<TopicMetrics::Snapshot> SystemHandle::get_metrics() const
+{
+    return participant_->metrics().snapshot();
+}
+
+bool SystemHandle::subscribe(
+        const std::string& topic_name,
+        const xtypes::DynamicType& message_type,
+        SubscriptionCallback* callback,
+        const YAML::Node& configuration)
+{
+    try
+    {
+        auto subscriber = std::make_shared<Subscriber>(
+            participant_.get(), topic_name, message_type, callback, configuration);
 
-            return true;
-        }
-        catch (DDSMiddlewareException& e)
-        {
-            e.from_logger << utils::Logger::Level::ERROR << e.what() << std::endl;
-            return false;
-        }
-    }
+        subscribers_.emplace_back(std::move(subscriber));
+
+        logger_ << utils::Logger::Level::INFO
+                << "Subscriber created for topic '" << topic_name << "', with type '"
+                << message_type.name() << "'" << std::endl;
 
-    bool is_internal_message(
-            void* filter_handle)
+        return true;
+    }
+    catch (DDSMiddlewareException& e)
     {
-        ::fastdds::dds::SampleInfo* sample_info = static_cast<::fastdds::dds::SampleInfo*>(filter_handle);
+        e.from_logger << utils::Logger::Level::ERROR << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool SystemHandle::is_internal_message(
+        void* filter_handle)
+{
+    ::fastdds::dds::SampleInfo* sample_info = static_cast<::fastdds::dds::SampleInfo*>(filter_handle);
 
-        auto sample_writer_guid = fastrtps::rtps::iHandle2GUID(sample_info->publication_handle);
+    auto sample_writer_guid = fastrtps::rtps::iHandle2GUID(sample_info->publication_handle);
 
-        if (sample_writer_guid.guidPrefix == participant_->get_dds_participant()->guid().guidPrefix)
+    if (sample_writer_guid.guidPrefix == participant_->get_dds_participant()->guid().guidPrefix)
+    {
+        if (utils::Logger::Level::DEBUG == logger_.get_level())
         {
-            if (utils::Logger::Level::DEBUG == logger_.get_level())
+            for (const auto& publisher : publishers_)
             {
-                for (const auto& publisher : publishers_)
+                if (sample_writer_guid == fastrtps::rtps::iHandle2GUID(publisher->get_dds_instance_handle()))
                 {
-                    if (sample_writer_guid == fastrtps::rtps::iHandle2GUID(publisher->get_dds_instance_handle()))
-                    {
-                        logger_ << utils::Logger::Level::DEBUG
-                                << "Received internal message from publisher '"
-                                << publisher->topic_name() << "', ignoring it..." << std::endl;
-
-                        break;
-                    }
+                    logger_ << utils::Logger::Level::DEBUG
+                            << "Received internal message from publisher '"
+                            << publisher->topic_name() << "', ignoring it..." << std::endl;
+
+                    break;
                 }
             }
-            // This is a message published FROM Integration Service. Discard it.
-            return true;
         }
-
-        return false;
+        // This is a message published FROM Integration Service. Discard it.
+        return true;
     }
 
-    std::shared_ptr<TopicPublisher> advertise(
-            const std::string& topic_name,
-            const xtypes::DynamicType& message_type,
-            const YAML::Node& configuration) override
+    return false;
+}
+
+std::shared_ptr<TopicPublisher> SystemHandle::advertise(
+        const std::string& topic_name,
+        const xtypes::DynamicType& message_type,
+        const YAML::Node& configuration)
+{
+    try
     {
-        try
-        {
-            auto publisher = std::make_shared<Publisher>(
-                participant_.get(), topic_name, message_type, configuration);
-            publishers_.emplace_back(std::move(publisher));
+        auto publisher = std::make_shared<Publisher>(
+            participant_.get(), topic_name, message_type, configuration);
+        publishers_.emplace_back(std::move(publisher));
 
-            logger_ << utils::Logger::Level::INFO
-                    << "Publisher created for topic '" << topic_name << "', with type '"
-                    << message_type.name() << "'" << std::endl;
+        logger_ << utils::Logger::Level::INFO
+                << "Publisher created for topic '" << topic_name << "', with type '"
+                << message_type.name() << "'" << std::endl;
 
-            return publishers_.back();
-        }
-        catch (DDSMiddlewareException& e)
-        {
-            e.from_logger << utils::Logger::Level::ERROR << e.what() << std::endl;
-            return std::shared_ptr<TopicPublisher>();
-        }
+        return publishers_.back();
     }
-
-    bool create_client_proxy(
-            const std::string& service_name,
-            const xtypes::DynamicType& type,
-            RequestCallback* callback,
-            const YAML::Node& configuration) override
+    catch (DDSMiddlewareException& e)
     {
-        return create_client_proxy(service_name, type, type, callback, configuration);
+        e.from_logger << utils::Logger::Level::ERROR << e.what() << std::endl;
+        return std::shared_ptr<TopicPublisher>();
     }
+}
 
-    bool create_client_proxy(
-            const std::string& service_name,
-            const xtypes::DynamicType& request_type,
-            const xtypes::DynamicType& reply_type,
-            RequestCallback* callback,
-            const YAML::Node& configuration) override
+bool SystemHandle::create_client_proxy(
+        const std::string& service_name,
+        const xtypes::DynamicType& type,
+        RequestCallback* callback,
+        const YAML::Node& configuration)
+{
+    return create_client_proxy(service_name, type, type, callback, configuration);
+}
+
+bool SystemHandle::create_client_proxy(
+        const std::string& service_name,
+        const xtypes::DynamicType& request_type,
+        const xtypes::DynamicType& reply_type,
+        RequestCallback* callback,
+        const YAML::Node& configuration)
+{
+    if (clients_.count(service_name) == 0)
     {
-        if (clients_.count(service_name) == 0)
+        try
         {
-            try
-            {
-                auto client = std::make_shared<Client>(
-                    participant_.get(),
-                    service_name,
-                    request_type,
-                    reply_type,
-                    callback,
-                    configuration);
+            auto client = std::make_shared<Client>(
+                participant_.get(),
+                service_name,
+                request_type,
+                reply_type,
+                callback,
+                configuration);
 
-                clients_[service_name] = std::move(client);
+            clients_[service_name] = std::move(client);
 
-                logger_ << utils::Logger::Level::INFO
-                        << "Client created for service '" << service_name
-                        << "', with request_type '" << request_type.name()
-                        << "' and reply_type '" << reply_type.name() << "'" << std::endl;
+            logger_ << utils::Logger::Level::INFO
+                    << "Client created for service '" << service_name
+                    << "', with request_type '" << request_type.name()
+                    << "' and reply_type '" << reply_type.name() << "'" << std::endl;
 
-                return true;
+            return true;
 
-            }
-            catch (DDSMiddlewareException& e)
-            {
-                e.from_logger << utils::Logger::Level::ERROR << e.what() << std::endl;
-                return false;
-            }
         }
-
-        return clients_[service_name]->add_config(configuration, callback);
+        catch (DDSMiddlewareException& e)
+        {
+            e.from_logger << utils::Logger::Level::ERROR << e.what() << std::endl;
+            return false;
+        }
     }
 
-    std::shared_ptr<ServiceProvider> create_service_proxy(
-            const std::string& service_name,
-            const xtypes::DynamicType& type,
-            const YAML::Node& configuration) override
-    {
-        return create_service_proxy(service_name, type, type, configuration);
-    }
+    return clients_[service_name]->add_config(configuration, callback);
+}
 
-    std::shared_ptr<ServiceProvider> create_service_proxy(
-            const std::string& service_name,
-            const xtypes::DynamicType& request_type,
-            const xtypes::DynamicType& reply_type,
-            const YAML::Node& configuration) override
+std::shared_ptr<ServiceProvider> SystemHandle::create_service_proxy(
+        const std::string& service_name,
+        const xtypes::DynamicType& type,
+        const YAML::Node& configuration)
+{
+    return create_service_proxy(service_name, type, type, configuration);
+}
+
+std::shared_ptr<ServiceProvider> SystemHandle::create_service_proxy(
+        const std::string& service_name,
+        const xtypes::DynamicType& request_type,
+        const xtypes::DynamicType& reply_type,
+        const YAML::Node& configuration)
+{
+    if (servers_.count(service_name) == 0)
     {
-        if (servers_.count(service_name) == 0)
+        try
         {
-            try
-            {
-                auto server = std::make_shared<Server>(
-                    participant_.get(),
-                    service_name,
-                    request_type,
-                    reply_type,
-                    configuration);
+            auto server = std::make_shared<Server>(
+                participant_.get(),
+                service_name,
+                request_type,
+                reply_type,
+                configuration);
 
-                servers_[service_name] = std::move(server);
+            servers_[service_name] = std::move(server);
 
-                logger_ << utils::Logger::Level::INFO
-                        << "Server created for service '" << service_name
-                        << "', with request_type '" << request_type.name()
-                        << "' and reply_type '" << reply_type.name() << "'" << std::endl;
-
-                return servers_[service_name];
-            }
-            catch (DDSMiddlewareException& e)
-            {
-                e.from_logger << utils::Logger::Level::ERROR << e.what() << std::endl;
-                return nullptr;
-            }
-        }
+            logger_ << utils::Logger::Level::INFO
+                    << "Server created for service '" << service_name
+                    << "', with request_type '" << request_type.name()
+                    << "' and reply_type '" << reply_type.name() << "'" << std::endl;
 
-        if (servers_[service_name]->add_config(configuration))
-        {
             return servers_[service_name];
         }
-        else
+        catch (DDSMiddlewareException& e)
         {
+            e.from_logger << utils::Logger::Level::ERROR << e.what() << std::endl;
             return nullptr;
         }
     }
 
-private:
-
-    std::unique_ptr<Participant> participant_;
-    std::vector<std::shared_ptr<Publisher> > publishers_;
-    std::vector<std::shared_ptr<Subscriber> > subscribers_;
-    std::map<std::string, std::shared_ptr<Client> > clients_;
-    std::map<std::string, std::shared_ptr<Server> > servers_;
-
-    utils::Logger logger_;
-};
+    if (servers_[service_name]->add_config(configuration))
+    {
+        return servers_[service_name];
+    }
+    else
+    {
+        return nullptr;
+    }
+}
 
 } //  namespace fastdds
 } //  namespace sh
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_FASTDDS__INTERNAL__SYSTEMHANDLE_HPP_
+#define _IS_SH_FASTDDS__INTERNAL__SYSTEMHANDLE_HPP_
+
+#include "Metrics.hpp"
+
+#include <is/systemhandle/SystemHandle.hpp>
+#include <is/utils/Log.hpp>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+/**
+ * @brief Forward declarations.
+ */
+class Client;
+class Participant;
+class Publisher;
+class Server;
+class Subscriber;
+
+/**
+ * @class SystemHandle
+ *        This class represents a full *Integration Service* system handle or plugin for the *DDS*
+ *        middleware, using eProsima's implementation, <a href="https://fast-dds.docs.eprosima.com/en/latest/">
+ *        Fast DDS</a>.
+ *
+ *        This class inherits from is::FullSystem, so to implement publisher, subscriber, and server/
+ *        client operations for the *Integration Service*.
+ *
+ */
+class SystemHandle : public virtual FullSystem
+{
+public:
+
+    /**
+     * @brief Construct a new SystemHandle object, which must be configured before being used.
+     */
+    SystemHandle();
+
+    /**
+     * @brief Destroy the SystemHandle object, dumping the metrics a last time if they are reported.
+     */
+    ~SystemHandle();
+
+    /**
+     * @brief Inherited from FullSystem.
+     */
+    bool configure(
+            const core::RequiredTypes& types,
+            const YAML::Node& configuration,
+            TypeRegistry& type_registry) override;
+
+    /**
+     * @brief Inherited from FullSystem.
+     */
+    bool okay() const override;
+
+    /**
+     * @brief Inherited from FullSystem.
+     */
+    bool spin_once() override;
+
+    /**
+     * @brief Get the current metrics of all the publishers, subscribers, clients and servers.
+     *        It gives the same figures as the `metrics` file, without their rates, and does not
+     *        require the `metrics` configuration.
+     *
+     *        This header is not installed, so this is only meant for the tests of this library;
+     *        *Integration Service* users read the metrics from the `metrics` file.
+     *
+     * @returns A snapshot of the metrics of each topic, per kind of entity.
+     */
+    std::vector<TopicMetrics::Snapshot> get_metrics() const;
+
+    /**
+     * @brief Inherited from FullSystem.
+     */
+    bool subscribe(
+            const std::string& topic_name,
+            const xtypes::DynamicType& message_type,
+            SubscriptionCallback* callback,
+            const YAML::Node& configuration) override;
+
+    /**
+     * @brief Check whether a received sample was published by this SystemHandle itself.
+     *
+     * @param[in] filter_handle The SampleInfo of the received sample.
+     */
+    bool is_internal_message(
+            void* filter_handle);
+
+    /**
+     * @brief Inherited from FullSystem.
+     */
+    std::shared_ptr<TopicPublisher> advertise(
+            const std::string& topic_name,
+            const xtypes::DynamicType& message_type,
+            const YAML::Node& configuration) override;
+
+    /**
+     * @brief Inherited from FullSystem.
+     */
+    bool create_client_proxy(
+            const std::string& service_name,
+            const xtypes::DynamicType& type,
+            RequestCallback* callback,
+            const YAML::Node& configuration) override;
+
+    /**
+     * @brief Inherited from FullSystem.
+     */
+    bool create_client_proxy(
+            const std::string& service_name,
+            const xtypes::DynamicType& request_type,
+            const xtypes::DynamicType& reply_type,
+            RequestCallback* callback,
+            const YAML::Node& configuration) override;
+
+    /**
+     * @brief Inherited from FullSystem.
+     */
+    std::shared_ptr<ServiceProvider> create_service_proxy(
+            const std::string& service_name,
+            const xtypes::DynamicType& type,
+            const YAML::Node& configuration) override;
+
+    /**
+     * @brief Inherited from FullSystem.
+     */
+    std::shared_ptr<ServiceProvider> create_service_proxy(
+            const std::string& service_name,
+            const xtypes::DynamicType& request_type,
+            const xtypes::DynamicType& reply_type,
+            const YAML::Node& configuration) override;
+
+private:
+
+    /**
+     * Class members.
+     */
+    std::unique_ptr<Participant> participant_;
+    std::unique_ptr<MetricsReporter> metrics_reporter_;
+    std::vector<std::shared_ptr<Publisher> > publishers_;
+    std::vector<std::shared_ptr<Subscriber> > subscribers_;
+    std::map<std::string, std::shared_ptr<Client> > clients_;
+    std::map<std::string, std::shared_ptr<Server> > servers_;
+
+    utils::Logger logger_;
+};
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_FASTDDS__INTERNAL__SYSTEMHANDLE_HPP_
@@ -0,0 +1,330 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <utility>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+constexpr std::size_t WorkerPool::DEFAULT_THREADS;
+constexpr std::size_t WorkerPool::DEFAULT_QUEUE_SIZE;
+
+WorkerPool::WorkerPool(
+        const std::string& name,
+        const YAML::Node& config,
+        Notifier notifier,
+        std::size_t default_threads)
+    : name_(name)
+    , queue_size_(DEFAULT_QUEUE_SIZE)
+    , overflow_policy_(OverflowPolicy::BLOCK)
+    , notifier_(std::move(notifier))
+    , dropped_(0)
+    , stop_(false)
+    , logger_("is::sh::FastDDS::WorkerPool")
+{
+    std::size_t threads = default_threads;
+
+    try
+    {
+        if (config["threads"])
+        {
+            threads = config["threads"].as<std::size_t>();
+        }
+
+        if (config["queue_size"])
+        {
+            queue_size_ = config["queue_size"].as<std::size_t>();
+        }
+
+        if (config["overflow"])
+        {
+            static const std::map<std::string, OverflowPolicy> policies = {
+                {"block", OverflowPolicy::BLOCK},
+                {"drop_oldest", OverflowPolicy::DROP_OLDEST},
+                {"drop_newest", OverflowPolicy::DROP_NEWEST},
+                {"keep_last_per_instance", OverflowPolicy::KEEP_LAST_PER_INSTANCE}
+            };
+
+            const std::string overflow = config["overflow"].as<std::string>();
+            auto policy = policies.find(overflow);
+            if (policies.end() == policy)
+            {
+                std::ostringstream err;
+                err << "Invalid reception configuration for '" << name_ << "': unknown 'overflow' policy '"
+                    << overflow << "'";
+
+                throw DDSMiddlewareException(logger_, err.str());
+            }
+            overflow_policy_ = policy->second;
+        }
+    }
+    catch (const YAML::Exception& e)
+    {
+        std::ostringstream err;
+        err << "Invalid reception configuration for '" << name_ << "': " << e.what();
+
+        throw DDSMiddlewareException(logger_, err.str());
+    }
+
+    if (0 == queue_size_)
+    {
+        std::ostringstream err;
+        err << "Invalid reception configuration for '" << name_
+            << "': 'queue_size' must be greater than zero";
+
+        throw DDSMiddlewareException(logger_, err.str());
+    }
+
+    workers_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        workers_.emplace_back(&WorkerPool::worker_function, this);
+    }
+
+    logger_ << utils::Logger::Level::DEBUG
+            << "Created " << (spin_driven() ? "spin-driven " : "") << "worker pool for '" << name_
+            << "' with " << threads << " threads and a queue of " << queue_size_ << " elements" << std::endl;
+}
+
+WorkerPool::~WorkerPool()
+{
+    stop();
+}
+
+bool WorkerPool::push(
+        Task&& task,
+        Task&& discard,
+        const std::string& instance)
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+
+    if (OverflowPolicy::BLOCK == overflow_policy_)
+    {
+        not_full_cv_.wait(
+            lock,
+            [this]()
+            {
+                return stop_ || queue_.size() < queue_size_;
+            });
+    }
+
+    // Dropped tasks are discarded out of the lock, as releasing their resources may take a while
+    Entry dropped_entry;
+    bool enqueued = true;
+
+    if (stop_)
+    {
+        dropped_entry.discard = std::move(discard);
+        enqueued = false;
+    }
+    else if (OverflowPolicy::KEEP_LAST_PER_INSTANCE == overflow_policy_ && !instance.empty())
+    {
+        // The queue is short, so a linear search is cheaper than keeping an index of the instances
+        auto queued = std::find_if(queue_.begin(), queue_.end(), [&instance](const Entry& entry)
+                        {
+                            return entry.instance == instance;
+                        });
+
+        if (queue_.end() != queued)
+        {
+            dropped_entry = std::move(*queued);
+            *queued = Entry{std::move(task), std::move(discard), instance};
+        }
+        else
+        {
+            if (queue_.size() >= queue_size_)
+            {
+                dropped_entry = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            queue_.push_back(Entry{std::move(task), std::move(discard), instance});
+        }
+    }
+    else if (queue_.size() >= queue_size_)
+    {
+        if (OverflowPolicy::DROP_NEWEST == overflow_policy_)
+        {
+            dropped_entry.discard = std::move(discard);
+            enqueued = false;
+        }
+        else
+        {
+            dropped_entry = std::move(queue_.front());
+            queue_.pop_front();
+            queue_.push_back(Entry{std::move(task), std::move(discard), instance});
+        }
+    }
+    else
+    {
+        queue_.push_back(Entry{std::move(task), std::move(discard), instance});
+    }
+
+    const bool drop = !enqueued || dropped_entry.task || dropped_entry.discard;
+    if (drop && !stop_)
+    {
+        ++dropped_;
+    }
+
+    if (enqueued)
+    {
+        not_empty_cv_.notify_one();
+    }
+    lock.unlock();
+
+    if (dropped_entry.discard)
+    {
+        dropped_entry.discard();
+    }
+
+    if (enqueued && notifier_)
+    {
+        notifier_();
+    }
+
+    return enqueued;
+}
+
+std::size_t WorkerPool::run_pending()
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+
+    // Only the tasks already enqueued are run, so that a fast producer cannot starve the caller
+    std::size_t count = queue_.size();
+    for (std::size_t i = 0; i < count && !queue_.empty(); ++i)
+    {
+        Task task = std::move(queue_.front().task);
+        queue_.pop_front();
+        not_full_cv_.notify_one();
+
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+
+    return count;
+}
+
+void WorkerPool::stop()
+{
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        stop_ = true;
+    }
+
+    not_empty_cv_.notify_all();
+    not_full_cv_.notify_all();
+
+    for (std::thread& worker : workers_)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+
+    if (spin_driven())
+    {
+        run_pending();
+    }
+}
+
+bool WorkerPool::spin_driven() const
+{
+    return workers_.empty();
+}
+
+std::size_t WorkerPool::pending() const
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    return queue_.size();
+}
+
+std::size_t WorkerPool::dropped() const
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    return dropped_;
+}
+
+WorkerPool::OverflowPolicy WorkerPool::overflow_policy() const
+{
+    return overflow_policy_;
+}
+
+std::deque<WorkerPool::Entry>::iterator WorkerPool::next_runnable()
+{
+    // The oldest task of each instance comes first, so the instances keep their order
+    return std::find_if(queue_.begin(), queue_.end(), [this](const Entry& entry)
+                   {
+                       return entry.instance.empty() || 0 == busy_instances_.count(entry.instance);
+                   });
+}
+
+void WorkerPool::worker_function()
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+
+    while (true)
+    {
+        std::deque<Entry>::iterator next = queue_.end();
+        not_empty_cv_.wait(
+            lock,
+            [this, &next]()
+            {
+                next = next_runnable();
+                return queue_.end() != next || (stop_ && queue_.empty());
+            });
+
+        // Drain the queue before quitting, so that no accepted sample is lost
+        if (queue_.end() == next)
+        {
+            break;
+        }
+
+        Task task = std::move(next->task);
+        std::string instance = std::move(next->instance);
+        queue_.erase(next);
+        not_full_cv_.notify_one();
+
+        if (!instance.empty())
+        {
+            busy_instances_.insert(instance);
+        }
+
+        lock.unlock();
+        task();
+        lock.lock();
+
+        if (!instance.empty())
+        {
+            // Later tasks of the instance may be waiting for this one to finish
+            busy_instances_.erase(instance);
+            not_empty_cv_.notify_all();
+        }
+    }
+}
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
@@ -0,0 +1,262 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_FASTDDS__INTERNAL__WORKERPOOL_HPP_
+#define _IS_SH_FASTDDS__INTERNAL__WORKERPOOL_HPP_
+
+#include "DDSMiddlewareException.hpp"
+
+#include <is/utils/Log.hpp>
+
+#include <yaml-cpp/yaml.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+/**
+ * @class WorkerPool
+ *        Fixed set of worker threads consuming tasks from a bounded queue.
+ *
+ *        It is used by the *Fast DDS* entities of this system handle to process
+ *        incoming samples (conversion and *Integration Service* callback) out of the
+ *        *Fast DDS* listener thread, without creating a new thread per sample.
+ *
+ *        The amount of tasks waiting to be processed is always bounded. When the queue is full,
+ *        the OverflowPolicy decides whether the producer is blocked until a worker frees a slot,
+ *        or some task is dropped.
+ *
+ *        Tasks may belong to an instance: those of the same instance are executed one at a time,
+ *        in the order they were pushed, while tasks of different instances run in parallel.
+ *
+ *        A pool without worker threads is spin-driven: its tasks are only executed when
+ *        the owner calls run_pending(), typically from the *Integration Service* spinning thread.
+ */
+class WorkerPool
+{
+public:
+
+    /**
+     * @brief Signature of the tasks executed by the pool.
+     */
+    using Task = std::function<void ()>;
+
+    /**
+     * @brief Signature of the function notified each time a task is enqueued.
+     */
+    using Notifier = std::function<void ()>;
+
+    /**
+     * @brief What to do when a task is pushed and the queue is full.
+     */
+    enum class OverflowPolicy
+    {
+        /** Block the producer until a worker frees a slot. */
+        BLOCK,
+
+        /** Drop the oldest task in the queue to make room for the new one. */
+        DROP_OLDEST,
+
+        /** Drop the new task. */
+        DROP_NEWEST,
+
+        /**
+         * A new task replaces the queued one of the same instance, if any, keeping its position
+         * in the queue. Otherwise, if the queue is full, the oldest task is dropped.
+         */
+        KEEP_LAST_PER_INSTANCE
+    };
+
+    /**
+     * @brief Default number of worker threads. A single worker preserves the reception order.
+     */
+    static constexpr std::size_t DEFAULT_THREADS = 1;
+
+    /**
+     * @brief Default maximum number of tasks waiting in the queue.
+     */
+    static constexpr std::size_t DEFAULT_QUEUE_SIZE = 256;
+
+    /**
+     * @brief Construct a new WorkerPool object, and start its worker threads.
+     *
+     * @param[in] name Name of the entity owning the pool, used for logging purposes.
+     *
+     * @param[in] config The *YAML* configuration of the pool. The following keys are allowed:
+     *            - `threads`: Number of worker threads. `0` makes the pool spin-driven.
+     *            - `queue_size`: Maximum number of tasks waiting to be processed.
+     *            - `overflow`: The OverflowPolicy, one of `block` (default), `drop_oldest`,
+     *              `drop_newest` or `keep_last_per_instance`.
+     *
+     * @param[in] notifier Optional function called each time a task is enqueued, out of the pool lock.
+     *
+     * @param[in] default_threads Number of worker threads if the configuration does not set them.
+     *
+     * @throws DDSMiddlewareException if the provided configuration is not valid.
+     */
+    WorkerPool(
+            const std::string& name,
+            const YAML::Node& config,
+            Notifier notifier = Notifier(),
+            std::size_t default_threads = DEFAULT_THREADS);
+
+    /**
+     * @brief Destroy the WorkerPool object. Pending tasks are processed before leaving.
+     */
+    ~WorkerPool();
+
+    /**
+     * @brief WorkerPool shall not be copy constructible.
+     */
+    WorkerPool(
+            const WorkerPool& /*rhs*/) = delete;
+
+    /**
+     * @brief WorkerPool shall not be copy assignable.
+     */
+    WorkerPool& operator = (
+            const WorkerPool& /*rhs*/) = delete;
+
+    /**
+     * @brief WorkerPool shall not be move constructible.
+     */
+    WorkerPool(
+            WorkerPool&& /*rhs*/) = delete;
+
+    /**
+     * @brief WorkerPool shall not be move assignable.
+     */
+    WorkerPool& operator = (
+            WorkerPool&& /*rhs*/) = delete;
+
+    /**
+     * @brief Enqueue a new task. If the queue is full, the overflow policy applies.
+     *
+     * @param[in] task The task to be executed by one of the workers.
+     *
+     * @param[in] discard Optional function called, instead of the task, if the task is dropped
+     *            or the pool is already stopped. It must release whatever the task owns.
+     *
+     * @param[in] instance Key of the instance the task belongs to, if any. The tasks of an instance are
+     *            executed in order, and replace each other under the `KEEP_LAST_PER_INSTANCE` policy.
+     *
+     * @returns `true` if the task was enqueued, or `false` if it was discarded.
+     */
+    bool push(
+            Task&& task,
+            Task&& discard = Task(),
+            const std::string& instance = std::string());
+
+    /**
+     * @brief Execute, in the calling thread, the tasks enqueued so far.
+     *
+     * @returns The number of executed tasks.
+     */
+    std::size_t run_pending();
+
+    /**
+     * @brief Stop accepting tasks, wait until the pending ones are processed and join the workers.
+     *        The pending tasks of a spin-driven pool are executed in the calling thread.
+     */
+    void stop();
+
+    /**
+     * @brief Check whether the pool has no worker threads.
+     *
+     * @returns `true` if the tasks are only executed through run_pending().
+     */
+    bool spin_driven() const;
+
+    /**
+     * @brief Get the number of tasks waiting to be processed.
+     *
+     * @returns The current depth of the queue.
+     */
+    std::size_t pending() const;
+
+    /**
+     * @brief Get the number of tasks dropped so far, because of the overflow policy.
+     */
+    std::size_t dropped() const;
+
+    /**
+     * @brief Get the overflow policy of the pool.
+     */
+    OverflowPolicy overflow_policy() const;
+
+private:
+
+    /**
+     * @brief A queued task, along with the function to call if it is dropped.
+     */
+    struct Entry
+    {
+        Task task;
+        Task discard;
+        std::string instance;
+    };
+
+    /**
+     * @brief Take the oldest task whose instance is not being processed by another worker.
+     *        Must be called with the pool lock held.
+     *
+     * @returns An iterator to the task in the queue, or its end if no task can be run now.
+     */
+    std::deque<Entry>::iterator next_runnable();
+
+    /**
+     * @brief Main loop of each worker thread.
+     */
+    void worker_function();
+
+    /**
+     * Class members.
+     */
+    const std::string name_;
+    std::size_t queue_size_;
+    OverflowPolicy overflow_policy_;
+    Notifier notifier_;
+
+    std::deque<Entry> queue_;
+    std::unordered_set<std::string> busy_instances_;
+    std::size_t dropped_;
+    bool stop_;
+    mutable std::mutex mtx_;
+    std::condition_variable not_empty_cv_;
+    std::condition_variable not_full_cv_;
+
+    std::vector<std::thread> workers_;
+
+    utils::Logger logger_;
+};
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_FASTDDS__INTERNAL__WORKERPOOL_HPP_
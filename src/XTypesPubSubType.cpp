@@ -0,0 +1,982 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "XTypesPubSubType.hpp"
+
+#include <fastrtps/types/DynamicData.h>
+#include <fastrtps/utils/md5.h>
+
+#include <fastcdr/FastBuffer.h>
+#include <fastcdr/exceptions/Exception.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+using eprosima::fastcdr::Cdr;
+
+namespace {
+
+const ::xtypes::DynamicType& resolve_type(
+        const ::xtypes::DynamicType& type)
+{
+    if (type.kind() == ::xtypes::TypeKind::ALIAS_TYPE)
+    {
+        return static_cast<const ::xtypes::AliasType&>(type).rget();
+    }
+
+    return type;
+}
+
+/*
+ * CDR size and alignment of a primitive kind, or 0 if the kind is not primitive.
+ * 16-bit integers are plain 2-byte CDR values, while, as in the Fast DDS Dynamic Types, both
+ * char16 and wide characters are serialized as a 4-byte wchar_t.
+ */
+size_t primitive_size(
+        ::xtypes::TypeKind kind,
+        size_t& align)
+{
+    switch (kind)
+    {
+        case ::xtypes::TypeKind::BOOLEAN_TYPE:
+        case ::xtypes::TypeKind::CHAR_8_TYPE:
+        case ::xtypes::TypeKind::UINT_8_TYPE:
+        case ::xtypes::TypeKind::INT_8_TYPE:
+            align = 1;
+            return 1;
+        case ::xtypes::TypeKind::INT_16_TYPE:
+        case ::xtypes::TypeKind::UINT_16_TYPE:
+            align = 2;
+            return 2;
+        case ::xtypes::TypeKind::INT_32_TYPE:
+        case ::xtypes::TypeKind::UINT_32_TYPE:
+        case ::xtypes::TypeKind::FLOAT_32_TYPE:
+        case ::xtypes::TypeKind::CHAR_16_TYPE:
+        case ::xtypes::TypeKind::WIDE_CHAR_TYPE:
+        case ::xtypes::TypeKind::ENUMERATION_TYPE:
+            align = 4;
+            return 4;
+        case ::xtypes::TypeKind::INT_64_TYPE:
+        case ::xtypes::TypeKind::UINT_64_TYPE:
+        case ::xtypes::TypeKind::FLOAT_64_TYPE:
+            align = 8;
+            return 8;
+        case ::xtypes::TypeKind::FLOAT_128_TYPE:
+            align = 8;
+            return 16;
+        default:
+            align = 1;
+            return 0;
+    }
+}
+
+template<typename T>
+void serialize_array(
+        ::xtypes::ReadableDynamicDataRef data,
+        Cdr& cdr)
+{
+    const std::vector<T> values = data.as_vector<T>();
+    cdr.serializeArray(values.data(), values.size());
+}
+
+/*
+ * Serialize at once the elements of a sequence or array of primitive types.
+ * Returns false if the elements kind is not eligible for it.
+ */
+bool serialize_primitive_collection(
+        ::xtypes::ReadableDynamicDataRef data,
+        ::xtypes::TypeKind kind,
+        Cdr& cdr)
+{
+    switch (kind)
+    {
+        case ::xtypes::TypeKind::CHAR_8_TYPE:
+            serialize_array<char>(data, cdr);
+            return true;
+        case ::xtypes::TypeKind::UINT_8_TYPE:
+            serialize_array<uint8_t>(data, cdr);
+            return true;
+        case ::xtypes::TypeKind::INT_8_TYPE:
+            serialize_array<int8_t>(data, cdr);
+            return true;
+        case ::xtypes::TypeKind::INT_16_TYPE:
+            serialize_array<int16_t>(data, cdr);
+            return true;
+        case ::xtypes::TypeKind::UINT_16_TYPE:
+            serialize_array<uint16_t>(data, cdr);
+            return true;
+        case ::xtypes::TypeKind::INT_32_TYPE:
+            serialize_array<int32_t>(data, cdr);
+            return true;
+        case ::xtypes::TypeKind::UINT_32_TYPE:
+            serialize_array<uint32_t>(data, cdr);
+            return true;
+        case ::xtypes::TypeKind::INT_64_TYPE:
+            serialize_array<int64_t>(data, cdr);
+            return true;
+        case ::xtypes::TypeKind::UINT_64_TYPE:
+            serialize_array<uint64_t>(data, cdr);
+            return true;
+        case ::xtypes::TypeKind::FLOAT_32_TYPE:
+            serialize_array<float>(data, cdr);
+            return true;
+        case ::xtypes::TypeKind::FLOAT_64_TYPE:
+            serialize_array<double>(data, cdr);
+            return true;
+        case ::xtypes::TypeKind::FLOAT_128_TYPE:
+            serialize_array<long double>(data, cdr);
+            return true;
+        default:
+            return false;
+    }
+}
+
+template<typename T>
+void deserialize_array(
+        ::xtypes::WritableDynamicDataRef data,
+        size_t count,
+        Cdr& cdr)
+{
+    std::vector<T> values(count);
+    cdr.deserializeArray(values.data(), count);
+    data = values;
+}
+
+/*
+ * Deserialize at once the elements of a sequence or array of primitive types.
+ * Returns false if the elements kind is not eligible for it.
+ */
+bool deserialize_primitive_collection(
+        ::xtypes::WritableDynamicDataRef data,
+        ::xtypes::TypeKind kind,
+        size_t count,
+        Cdr& cdr)
+{
+    switch (kind)
+    {
+        case ::xtypes::TypeKind::CHAR_8_TYPE:
+            deserialize_array<char>(data, count, cdr);
+            return true;
+        case ::xtypes::TypeKind::UINT_8_TYPE:
+            deserialize_array<uint8_t>(data, count, cdr);
+            return true;
+        case ::xtypes::TypeKind::INT_8_TYPE:
+            deserialize_array<int8_t>(data, count, cdr);
+            return true;
+        case ::xtypes::TypeKind::INT_16_TYPE:
+            deserialize_array<int16_t>(data, count, cdr);
+            return true;
+        case ::xtypes::TypeKind::UINT_16_TYPE:
+            deserialize_array<uint16_t>(data, count, cdr);
+            return true;
+        case ::xtypes::TypeKind::INT_32_TYPE:
+            deserialize_array<int32_t>(data, count, cdr);
+            return true;
+        case ::xtypes::TypeKind::UINT_32_TYPE:
+            deserialize_array<uint32_t>(data, count, cdr);
+            return true;
+        case ::xtypes::TypeKind::INT_64_TYPE:
+            deserialize_array<int64_t>(data, count, cdr);
+            return true;
+        case ::xtypes::TypeKind::UINT_64_TYPE:
+            deserialize_array<uint64_t>(data, count, cdr);
+            return true;
+        case ::xtypes::TypeKind::FLOAT_32_TYPE:
+            deserialize_array<float>(data, count, cdr);
+            return true;
+        case ::xtypes::TypeKind::FLOAT_64_TYPE:
+            deserialize_array<double>(data, count, cdr);
+            return true;
+        case ::xtypes::TypeKind::FLOAT_128_TYPE:
+            deserialize_array<long double>(data, count, cdr);
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*
+ * Whether all the instances of a type have the same CDR layout, that is, whether it only contains
+ * primitive types, enumerations, and arrays and structures of them.
+ */
+bool is_plain_type(
+        const ::xtypes::DynamicType& type)
+{
+    const ::xtypes::DynamicType& resolved = resolve_type(type);
+
+    switch (resolved.kind())
+    {
+        case ::xtypes::TypeKind::STRUCTURE_TYPE:
+        {
+            const ::xtypes::StructType& struct_type = static_cast<const ::xtypes::StructType&>(resolved);
+            for (const ::xtypes::Member& member : struct_type.members())
+            {
+                if (!is_plain_type(member.type()))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case ::xtypes::TypeKind::ARRAY_TYPE:
+            return is_plain_type(static_cast<const ::xtypes::CollectionType&>(resolved).content_type());
+        default:
+        {
+            size_t align;
+            return 0 < primitive_size(resolved.kind(), align);
+        }
+    }
+}
+
+/*
+ * Whether a type is a structure with some `@key` member, which makes its topics keyed.
+ */
+bool has_key_members(
+        const ::xtypes::DynamicType& type)
+{
+    const ::xtypes::DynamicType& resolved = resolve_type(type);
+    if (resolved.kind() != ::xtypes::TypeKind::STRUCTURE_TYPE)
+    {
+        return false;
+    }
+
+    const ::xtypes::StructType& struct_type = static_cast<const ::xtypes::StructType&>(resolved);
+    return std::any_of(struct_type.members().begin(), struct_type.members().end(), [](const ::xtypes::Member& member)
+                   {
+                       return member.is_key();
+                   });
+}
+
+/*
+ * Position of a case among the members of a union, which is the MemberId given to it by Conversion::get_builder.
+ * The Fast DDS DynamicData serializes this MemberId instead of the discriminator value.
+ */
+uint32_t case_member_id(
+        const ::xtypes::UnionType& union_type,
+        const std::string& member_name)
+{
+    const std::vector<std::string> members = union_type.get_case_members();
+    return static_cast<uint32_t>(std::distance(members.begin(),
+           std::find(members.begin(), members.end(), member_name)));
+}
+
+} //  anonymous namespace
+
+// Static member initialization
+utils::Logger XTypesPubSubType::logger_("is::sh::FastDDS::XTypesPubSubType");
+
+XTypesPubSubType::XTypesPubSubType(
+        const xtypes::DynamicType& type,
+        fastrtps::types::DynamicType_ptr dds_type)
+    : type_(type)
+    , plain_(false)
+{
+    setName(type.name().c_str());
+    m_typeSize = static_cast<uint32_t>(fastrtps::types::DynamicData::getMaxCdrSerializedSize(dds_type) + 4);
+    m_isGetKeyDefined = has_key_members(type);
+
+    if (m_isGetKeyDefined)
+    {
+        // Keys up to 16 bytes are used as the instance handle as is, so the rest of it must be zeroed
+        key_buffer_.resize(std::max<size_t>(16, fastrtps::types::DynamicData::getKeyMaxCdrSerializedSize(dds_type)));
+    }
+
+    // The samples of a plain type always fill the same bytes, so they can be written straight into loaned payloads.
+    // Keyed types are excluded, as Fast DDS calls getKey with the loaned payload instead of an xtypes data.
+    if (!m_isGetKeyDefined && is_plain_type(type))
+    {
+        plain_ = serialized_size(::xtypes::DynamicData(type), 0) + 4 <= m_typeSize;
+    }
+
+    // Same workaround as for the DynamicPubSubType, see Participant::register_dynamic_type
+    auto_fill_type_information(false);
+    auto_fill_type_object(false);
+}
+
+bool XTypesPubSubType::serialize(
+        void* data,
+        fastrtps::rtps::SerializedPayload_t* payload)
+{
+    const ::xtypes::DynamicData* xtypes_data = static_cast<const ::xtypes::DynamicData*>(data);
+
+    eprosima::fastcdr::FastBuffer fastbuffer(reinterpret_cast<char*>(payload->data), payload->max_size);
+    Cdr ser(fastbuffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+    payload->encapsulation = ser.endianness() == Cdr::BIG_ENDIANNESS ? CDR_BE : CDR_LE;
+
+    try
+    {
+        ser.serialize_encapsulation();
+
+        if (!serialize_data(*xtypes_data, ser))
+        {
+            return false;
+        }
+    }
+    catch (eprosima::fastcdr::exception::NotEnoughMemoryException& /*exception*/)
+    {
+        logger_ << utils::Logger::Level::ERROR
+                << "Not enough memory to serialize a message of type '"
+                << type_->name() << "'" << std::endl;
+
+        return false;
+    }
+
+    payload->length = static_cast<uint32_t>(ser.getSerializedDataLength());
+    return true;
+}
+
+bool XTypesPubSubType::deserialize(
+        fastrtps::rtps::SerializedPayload_t* payload,
+        void* data)
+{
+    ::xtypes::DynamicData* xtypes_data = static_cast<::xtypes::DynamicData*>(data);
+
+    eprosima::fastcdr::FastBuffer fastbuffer(reinterpret_cast<char*>(payload->data), payload->length);
+    Cdr deser(fastbuffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+
+    try
+    {
+        deser.read_encapsulation();
+        payload->encapsulation = deser.endianness() == Cdr::BIG_ENDIANNESS ? CDR_BE : CDR_LE;
+
+        return deserialize_data(xtypes_data->ref(), deser);
+    }
+    catch (eprosima::fastcdr::exception::Exception& e)
+    {
+        logger_ << utils::Logger::Level::ERROR
+                << "Failed to deserialize a message of type '" << type_->name()
+                << "': " << e.what() << std::endl;
+
+        return false;
+    }
+}
+
+std::function<uint32_t()> XTypesPubSubType::getSerializedSizeProvider(
+        void* data)
+{
+    return [data]() -> uint32_t
+           {
+               // Encapsulation header plus the data
+               return static_cast<uint32_t>(
+                   serialized_size(*static_cast<const ::xtypes::DynamicData*>(data), 0) + 4);
+           };
+}
+
+void* XTypesPubSubType::createData()
+{
+    return new ::xtypes::DynamicData(*type_);
+}
+
+void XTypesPubSubType::deleteData(
+        void* data)
+{
+    delete static_cast<::xtypes::DynamicData*>(data);
+}
+
+#if FASTRTPS_VERSION_MINOR >= 2
+bool XTypesPubSubType::is_bounded() const
+{
+    return plain_;
+}
+
+bool XTypesPubSubType::is_plain() const
+{
+    return plain_;
+}
+#endif //  if FASTRTPS_VERSION_MINOR >= 2
+
+bool XTypesPubSubType::plain() const
+{
+    return plain_;
+}
+
+bool XTypesPubSubType::serialize_plain(
+        const ::xtypes::DynamicData& data,
+        void* sample) const
+{
+    if (!plain_)
+    {
+        return false;
+    }
+
+    // The sample is the payload past the encapsulation header, which Fast DDS fills in on write
+    eprosima::fastcdr::FastBuffer fastbuffer(reinterpret_cast<char*>(sample), m_typeSize - 4);
+    Cdr ser(fastbuffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+
+    try
+    {
+        return serialize_data(data, ser);
+    }
+    catch (eprosima::fastcdr::exception::NotEnoughMemoryException& /*exception*/)
+    {
+        logger_ << utils::Logger::Level::ERROR
+                << "Not enough memory to serialize a message of type '"
+                << type_->name() << "' into a loaned sample" << std::endl;
+
+        return false;
+    }
+}
+
+bool XTypesPubSubType::getKey(
+        void* data,
+        fastrtps::rtps::InstanceHandle_t* ihandle,
+        bool force_md5)
+{
+    if (!m_isGetKeyDefined)
+    {
+        return false;
+    }
+
+    const ::xtypes::DynamicData* xtypes_data = static_cast<const ::xtypes::DynamicData*>(data);
+
+    // Both the datawriters and the datareaders of the type may ask for keys at the same time
+    std::unique_lock<std::mutex> lock(key_mtx_);
+
+    // The key is always serialized in big endian, for it to be the same on every host
+    eprosima::fastcdr::FastBuffer fastbuffer(key_buffer_.data(), key_buffer_.size());
+    Cdr ser(fastbuffer, Cdr::BIG_ENDIANNESS);
+
+    try
+    {
+        if (!serialize_key(*xtypes_data, ser))
+        {
+            return false;
+        }
+    }
+    catch (eprosima::fastcdr::exception::NotEnoughMemoryException& /*exception*/)
+    {
+        logger_ << utils::Logger::Level::ERROR
+                << "Not enough memory to serialize the key of a message of type '"
+                << type_->name() << "'" << std::endl;
+
+        return false;
+    }
+
+    if (force_md5 || key_buffer_.size() > 16)
+    {
+        MD5 md5;
+        md5.init();
+        md5.update(reinterpret_cast<const unsigned char*>(key_buffer_.data()),
+                static_cast<unsigned int>(ser.getSerializedDataLength()));
+        md5.finalize();
+
+        std::copy(md5.digest, md5.digest + 16, ihandle->value);
+    }
+    else
+    {
+        std::copy(key_buffer_.begin(), key_buffer_.begin() + 16, ihandle->value);
+    }
+
+    return true;
+}
+
+bool XTypesPubSubType::serialize_key(
+        ::xtypes::ReadableDynamicDataRef data,
+        Cdr& cdr)
+{
+    const ::xtypes::StructType& type = static_cast<const ::xtypes::StructType&>(resolve_type(data.type()));
+
+    for (const ::xtypes::Member& member : type.members())
+    {
+        // As in the Fast DDS Dynamic Types, nested structures contribute their own key members
+        if (resolve_type(member.type()).kind() == ::xtypes::TypeKind::STRUCTURE_TYPE)
+        {
+            if (!serialize_key(data[member.name()], cdr))
+            {
+                return false;
+            }
+        }
+        else if (member.is_key() && !serialize_data(data[member.name()], cdr))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool XTypesPubSubType::serialize_data(
+        ::xtypes::ReadableDynamicDataRef data,
+        Cdr& cdr)
+{
+    const ::xtypes::DynamicType& type = resolve_type(data.type());
+
+    switch (type.kind())
+    {
+        case ::xtypes::TypeKind::BOOLEAN_TYPE:
+            cdr << data.value<bool>();
+            break;
+        case ::xtypes::TypeKind::CHAR_8_TYPE:
+            cdr << data.value<char>();
+            break;
+        case ::xtypes::TypeKind::CHAR_16_TYPE:
+            cdr << static_cast<wchar_t>(data.value<char16_t>());
+            break;
+        case ::xtypes::TypeKind::WIDE_CHAR_TYPE:
+            cdr << data.value<wchar_t>();
+            break;
+        case ::xtypes::TypeKind::UINT_8_TYPE:
+            cdr << data.value<uint8_t>();
+            break;
+        case ::xtypes::TypeKind::INT_8_TYPE:
+            cdr << data.value<int8_t>();
+            break;
+        case ::xtypes::TypeKind::INT_16_TYPE:
+            cdr << data.value<int16_t>();
+            break;
+        case ::xtypes::TypeKind::UINT_16_TYPE:
+            cdr << data.value<uint16_t>();
+            break;
+        case ::xtypes::TypeKind::INT_32_TYPE:
+            cdr << data.value<int32_t>();
+            break;
+        case ::xtypes::TypeKind::UINT_32_TYPE:
+            cdr << data.value<uint32_t>();
+            break;
+        case ::xtypes::TypeKind::INT_64_TYPE:
+            cdr << data.value<int64_t>();
+            break;
+        case ::xtypes::TypeKind::UINT_64_TYPE:
+            cdr << data.value<uint64_t>();
+            break;
+        case ::xtypes::TypeKind::FLOAT_32_TYPE:
+            cdr << data.value<float>();
+            break;
+        case ::xtypes::TypeKind::FLOAT_64_TYPE:
+            cdr << data.value<double>();
+            break;
+        case ::xtypes::TypeKind::FLOAT_128_TYPE:
+            cdr << data.value<long double>();
+            break;
+        case ::xtypes::TypeKind::ENUMERATION_TYPE:
+            cdr << data.value<uint32_t>();
+            break;
+        case ::xtypes::TypeKind::STRING_TYPE:
+            cdr << data.value<std::string>();
+            break;
+        case ::xtypes::TypeKind::WSTRING_TYPE:
+            cdr << data.value<std::wstring>();
+            break;
+        case ::xtypes::TypeKind::SEQUENCE_TYPE:
+            // Once its length is written, a sequence is serialized as an array
+            cdr << static_cast<uint32_t>(data.size());
+            [[fallthrough]];
+        case ::xtypes::TypeKind::ARRAY_TYPE:
+        {
+            const ::xtypes::CollectionType& collection_type = static_cast<const ::xtypes::CollectionType&>(type);
+            if (!serialize_primitive_collection(data, resolve_type(collection_type.content_type()).kind(), cdr))
+            {
+                for (size_t idx = 0; idx < data.size(); ++idx)
+                {
+                    if (!serialize_data(data[idx], cdr))
+                    {
+                        return false;
+                    }
+                }
+            }
+            break;
+        }
+        case ::xtypes::TypeKind::MAP_TYPE:
+        {
+            cdr << static_cast<uint32_t>(data.size());
+            for (::xtypes::ReadableDynamicDataRef pair : data)
+            {
+                if (!serialize_data(pair[0], cdr) || !serialize_data(pair[1], cdr))
+                {
+                    return false;
+                }
+            }
+            break;
+        }
+        case ::xtypes::TypeKind::STRUCTURE_TYPE:
+        {
+            const ::xtypes::StructType& struct_type = static_cast<const ::xtypes::StructType&>(type);
+            for (size_t idx = 0; idx < struct_type.members().size(); ++idx)
+            {
+                if (!serialize_data(data[idx], cdr))
+                {
+                    return false;
+                }
+            }
+            break;
+        }
+        case ::xtypes::TypeKind::UNION_TYPE:
+        {
+            // Written as the Fast DDS DynamicData does, with the MemberId of the case instead of the discriminator
+            const ::xtypes::UnionType& union_type = static_cast<const ::xtypes::UnionType&>(type);
+            const std::string& selected = data.current_case().name();
+            cdr << case_member_id(union_type, selected);
+
+            if (!serialize_data(data[selected], cdr))
+            {
+                return false;
+            }
+            break;
+        }
+        default:
+        {
+            logger_ << utils::Logger::Level::ERROR
+                    << "Unsupported type '" << type.name() << "' in direct serialization" << std::endl;
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool XTypesPubSubType::deserialize_data(
+        ::xtypes::WritableDynamicDataRef data,
+        Cdr& cdr)
+{
+    const ::xtypes::DynamicType& type = resolve_type(data.type());
+
+    switch (type.kind())
+    {
+        case ::xtypes::TypeKind::BOOLEAN_TYPE:
+        {
+            bool value;
+            cdr >> value;
+            data.value<bool>(value);
+            break;
+        }
+        case ::xtypes::TypeKind::CHAR_8_TYPE:
+        {
+            char value;
+            cdr >> value;
+            data.value<char>(value);
+            break;
+        }
+        case ::xtypes::TypeKind::CHAR_16_TYPE:
+        {
+            wchar_t value;
+            cdr >> value;
+            data.value<char16_t>(static_cast<char16_t>(value));
+            break;
+        }
+        case ::xtypes::TypeKind::WIDE_CHAR_TYPE:
+        {
+            wchar_t value;
+            cdr >> value;
+            data.value<wchar_t>(value);
+            break;
+        }
+        case ::xtypes::TypeKind::UINT_8_TYPE:
+        {
+            uint8_t value;
+            cdr >> value;
+            data.value<uint8_t>(value);
+            break;
+        }
+        case ::xtypes::TypeKind::INT_8_TYPE:
+        {
+            int8_t value;
+            cdr >> value;
+            data.value<int8_t>(value);
+            break;
+        }
+        case ::xtypes::TypeKind::INT_16_TYPE:
+        {
+            int16_t value;
+            cdr >> value;
+            data.value<int16_t>(value);
+            break;
+        }
+        case ::xtypes::TypeKind::UINT_16_TYPE:
+        {
+            uint16_t value;
+            cdr >> value;
+            data.value<uint16_t>(value);
+            break;
+        }
+        case ::xtypes::TypeKind::INT_32_TYPE:
+        {
+            int32_t value;
+            cdr >> value;
+            data.value<int32_t>(value);
+            break;
+        }
+        case ::xtypes::TypeKind::UINT_32_TYPE:
+        {
+            uint32_t value;
+            cdr >> value;
+            data.value<uint32_t>(value);
+            break;
+        }
+        case ::xtypes::TypeKind::INT_64_TYPE:
+        {
+            int64_t value;
+            cdr >> value;
+            data.value<int64_t>(value);
+            break;
+        }
+        case ::xtypes::TypeKind::UINT_64_TYPE:
+        {
+            uint64_t value;
+            cdr >> value;
+            data.value<uint64_t>(value);
+            break;
+        }
+        case ::xtypes::TypeKind::FLOAT_32_TYPE:
+        {
+            float value;
+            cdr >> value;
+            data.value<float>(value);
+            break;
+        }
+        case ::xtypes::TypeKind::FLOAT_64_TYPE:
+        {
+            double value;
+            cdr >> value;
+            data.value<double>(value);
+            break;
+        }
+        case ::xtypes::TypeKind::FLOAT_128_TYPE:
+        {
+            long double value;
+            cdr >> value;
+            data.value<long double>(value);
+            break;
+        }
+        case ::xtypes::TypeKind::ENUMERATION_TYPE:
+        {
+            uint32_t value;
+            cdr >> value;
+            data.value<uint32_t>(value);
+            break;
+        }
+        case ::xtypes::TypeKind::STRING_TYPE:
+        {
+            std::string value;
+            cdr >> value;
+            data.value<std::string>(value);
+            break;
+        }
+        case ::xtypes::TypeKind::WSTRING_TYPE:
+        {
+            std::wstring value;
+            cdr >> value;
+            data.value<std::wstring>(value);
+            break;
+        }
+        case ::xtypes::TypeKind::SEQUENCE_TYPE:
+        {
+            const ::xtypes::SequenceType& sequence_type = static_cast<const ::xtypes::SequenceType&>(type);
+            uint32_t length;
+            cdr >> length;
+
+            if (0 < sequence_type.bounds() && sequence_type.bounds() < length)
+            {
+                logger_ << utils::Logger::Level::ERROR
+                        << "Received " << length << " elements for the sequence type '" << type.name()
+                        << "', bounded to " << sequence_type.bounds() << std::endl;
+
+                return false;
+            }
+
+            // The sequence is expected to be empty at this point
+            if (!deserialize_primitive_collection(
+                        data, resolve_type(sequence_type.content_type()).kind(), length, cdr))
+            {
+                ::xtypes::DynamicData element(sequence_type.content_type());
+                for (uint32_t idx = 0; idx < length; ++idx)
+                {
+                    data.push(element);
+                    if (!deserialize_data(data[idx], cdr))
+                    {
+                        return false;
+                    }
+                }
+            }
+            break;
+        }
+        case ::xtypes::TypeKind::ARRAY_TYPE:
+        {
+            const ::xtypes::ArrayType& array_type = static_cast<const ::xtypes::ArrayType&>(type);
+            if (!deserialize_primitive_collection(
+                        data, resolve_type(array_type.content_type()).kind(), array_type.dimension(), cdr))
+            {
+                for (uint32_t idx = 0; idx < array_type.dimension(); ++idx)
+                {
+                    if (!deserialize_data(data[idx], cdr))
+                    {
+                        return false;
+                    }
+                }
+            }
+            break;
+        }
+        case ::xtypes::TypeKind::MAP_TYPE:
+        {
+            const ::xtypes::MapType& map_type = static_cast<const ::xtypes::MapType&>(type);
+            const ::xtypes::PairType& pair_type = static_cast<const ::xtypes::PairType&>(map_type.content_type());
+            uint32_t length;
+            cdr >> length;
+
+            // The map is expected to be empty at this point
+            for (uint32_t idx = 0; idx < length; ++idx)
+            {
+                ::xtypes::DynamicData key_data(pair_type.first());
+                ::xtypes::DynamicData value_data(pair_type.second());
+
+                if (!deserialize_data(key_data.ref(), cdr) || !deserialize_data(value_data.ref(), cdr))
+                {
+                    return false;
+                }
+
+                data[key_data] = value_data;
+            }
+            break;
+        }
+        case ::xtypes::TypeKind::STRUCTURE_TYPE:
+        {
+            const ::xtypes::StructType& struct_type = static_cast<const ::xtypes::StructType&>(type);
+            for (size_t idx = 0; idx < struct_type.members().size(); ++idx)
+            {
+                if (!deserialize_data(data[idx], cdr))
+                {
+                    return false;
+                }
+            }
+            break;
+        }
+        case ::xtypes::TypeKind::UNION_TYPE:
+        {
+            const ::xtypes::UnionType& union_type = static_cast<const ::xtypes::UnionType&>(type);
+            uint32_t member_id;
+            cdr >> member_id;
+
+            const std::vector<std::string> members = union_type.get_case_members();
+            if (members.size() <= member_id)
+            {
+                logger_ << utils::Logger::Level::ERROR
+                        << "Received case " << member_id << " does not match any member of the union type '"
+                        << type.name() << "'" << std::endl;
+
+                return false;
+            }
+            const std::string& selected = members[member_id];
+
+            // The discriminator is set automatically when the member is accessed
+            if (!deserialize_data(data[selected], cdr))
+            {
+                return false;
+            }
+            break;
+        }
+        default:
+        {
+            logger_ << utils::Logger::Level::ERROR
+                    << "Unsupported type '" << type.name() << "' in direct deserialization" << std::endl;
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t XTypesPubSubType::serialized_size(
+        ::xtypes::ReadableDynamicDataRef data,
+        size_t current_alignment)
+{
+    const size_t initial_alignment = current_alignment;
+    const ::xtypes::DynamicType& type = resolve_type(data.type());
+
+    size_t align;
+    size_t size = primitive_size(type.kind(), align);
+    if (0 < size)
+    {
+        return size + Cdr::alignment(current_alignment, align);
+    }
+
+    switch (type.kind())
+    {
+        case ::xtypes::TypeKind::STRING_TYPE:
+            current_alignment += 4 + Cdr::alignment(current_alignment, 4);
+            current_alignment += data.value<std::string>().size() + 1;
+            break;
+        case ::xtypes::TypeKind::WSTRING_TYPE:
+            current_alignment += 4 + Cdr::alignment(current_alignment, 4);
+            current_alignment += data.value<std::wstring>().size() * 4;
+            break;
+        case ::xtypes::TypeKind::SEQUENCE_TYPE:
+            // Once its length is accounted, a sequence is measured as an array
+            current_alignment += 4 + Cdr::alignment(current_alignment, 4);
+            [[fallthrough]];
+        case ::xtypes::TypeKind::ARRAY_TYPE:
+        {
+            const ::xtypes::CollectionType& collection_type = static_cast<const ::xtypes::CollectionType&>(type);
+            size = primitive_size(resolve_type(collection_type.content_type()).kind(), align);
+            if (0 < size)
+            {
+                if (0 < data.size())
+                {
+                    current_alignment += Cdr::alignment(current_alignment, align) + size * data.size();
+                }
+            }
+            else
+            {
+                for (size_t idx = 0; idx < data.size(); ++idx)
+                {
+                    current_alignment += serialized_size(data[idx], current_alignment);
+                }
+            }
+            break;
+        }
+        case ::xtypes::TypeKind::MAP_TYPE:
+        {
+            current_alignment += 4 + Cdr::alignment(current_alignment, 4);
+            for (::xtypes::ReadableDynamicDataRef pair : data)
+            {
+                current_alignment += serialized_size(pair[0], current_alignment);
+                current_alignment += serialized_size(pair[1], current_alignment);
+            }
+            break;
+        }
+        case ::xtypes::TypeKind::STRUCTURE_TYPE:
+        {
+            const ::xtypes::StructType& struct_type = static_cast<const ::xtypes::StructType&>(type);
+            for (size_t idx = 0; idx < struct_type.members().size(); ++idx)
+            {
+                current_alignment += serialized_size(data[idx], current_alignment);
+            }
+            break;
+        }
+        case ::xtypes::TypeKind::UNION_TYPE:
+        {
+            // MemberId of the selected case
+            current_alignment += 4 + Cdr::alignment(current_alignment, 4);
+            current_alignment += serialized_size(data[data.current_case().name()], current_alignment);
+            break;
+        }
+        default:
+            break;
+    }
+
+    return current_alignment - initial_alignment;
+}
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _IS_SH_FASTDDS__INTERNAL__XTYPESPUBSUBTYPE_HPP_
+#define _IS_SH_FASTDDS__INTERNAL__XTYPESPUBSUBTYPE_HPP_
+
+#include <fastdds/dds/topic/TopicDataType.hpp>
+#include <fastrtps/types/DynamicTypePtr.h>
+
+#include <fastcdr/Cdr.h>
+
+#include <is/core/Message.hpp>
+#include <is/utils/Log.hpp>
+
+#include <mutex>
+#include <vector>
+
+namespace fastdds = eprosima::fastdds;
+namespace xtypes = eprosima::xtypes;
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+
+/**
+ * @class XTypesPubSubType
+ *        <a href="https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/topic/typeSupport/typeSupport.html">
+ *        Fast DDS TopicDataType</a> whose data samples are *xtypes* DynamicData instances.
+ *
+ *        It serializes the *Integration Service* messages straight into the CDR payload,
+ *        and deserializes them straight from it, following the same layout used by the
+ *        *Fast DDS* DynamicPubSubType for the equivalent *Dynamic Type*, so that no intermediate
+ *        *Fast DDS* DynamicData has to be built for each message.
+ */
+class XTypesPubSubType : public ::fastdds::dds::TopicDataType
+{
+public:
+
+    /**
+     * @brief Construct a new XTypesPubSubType object.
+     *
+     * @param[in] type The *xtypes* definition of the topic's type.
+     *
+     * @param[in] dds_type The equivalent *Fast DDS* Dynamic Type, used to compute the
+     *            maximum serialized size of the type.
+     */
+    XTypesPubSubType(
+            const xtypes::DynamicType& type,
+            fastrtps::types::DynamicType_ptr dds_type);
+
+    /**
+     * @brief Destroy the XTypesPubSubType object.
+     */
+    virtual ~XTypesPubSubType() override = default;
+
+    /**
+     * @brief Inherited from TopicDataType.
+     */
+    bool serialize(
+            void* data,
+            fastrtps::rtps::SerializedPayload_t* payload) override;
+
+    /**
+     * @brief Inherited from TopicDataType.
+     */
+    bool deserialize(
+            fastrtps::rtps::SerializedPayload_t* payload,
+            void* data) override;
+
+    /**
+     * @brief Inherited from TopicDataType.
+     */
+    std::function<uint32_t()> getSerializedSizeProvider(
+            void* data) override;
+
+    /**
+     * @brief Inherited from TopicDataType.
+     *
+     * @returns A new *xtypes* DynamicData instance of the topic's type.
+     */
+    void* createData() override;
+
+    /**
+     * @brief Inherited from TopicDataType.
+     */
+    void deleteData(
+            void* data) override;
+
+#if FASTRTPS_VERSION_MINOR >= 2
+    /**
+     * @brief Inherited from TopicDataType.
+     *
+     * @returns `true` if the type is plain.
+     */
+    bool is_bounded() const override;
+
+    /**
+     * @brief Inherited from TopicDataType.
+     *
+     * @returns `true` if the type is plain. Then, the samples loaned by the DataWriters
+     *          are raw CDR buffers to be filled in with serialize_plain, instead of *xtypes* data.
+     */
+    bool is_plain() const override;
+#endif //  if FASTRTPS_VERSION_MINOR >= 2
+
+    /**
+     * @brief Check whether all the instances of the type have the same CDR layout, that is,
+     *        it only contains primitive types, enumerations, and arrays and structures of them.
+     */
+    bool plain() const;
+
+    /**
+     * @brief Serialize an *xtypes* data instance of a plain type into a sample loaned by a DataWriter.
+     *
+     * @param[in] data The data to serialize.
+     *
+     * @param[out] sample The loaned sample, with room for `m_typeSize` bytes minus the encapsulation.
+     *
+     * @returns `false` if the type is not plain or the data could not be serialized.
+     */
+    bool serialize_plain(
+            const ::xtypes::DynamicData& data,
+            void* sample) const;
+
+    /**
+     * @brief Inherited from TopicDataType. Computes the instance handle from the `@key` members,
+     *        in the same way as the *Fast DDS* DynamicPubSubType.
+     *
+     * @returns `false` if the type has no key members.
+     */
+    bool getKey(
+            void* data,
+            fastrtps::rtps::InstanceHandle_t* ihandle,
+            bool force_md5 = false) override;
+
+private:
+
+    /**
+     * @brief Serialize an *xtypes* data instance into a CDR stream.
+     *
+     * @param[in] data The data to serialize.
+     *
+     * @param[in] cdr The CDR stream.
+     *
+     * @returns `false` if the type of the data cannot be serialized.
+     */
+    static bool serialize_data(
+            ::xtypes::ReadableDynamicDataRef data,
+            eprosima::fastcdr::Cdr& cdr);
+
+    /**
+     * @brief Deserialize an *xtypes* data instance from a CDR stream.
+     *
+     * @param[in] data The data to fill. Its sequences and maps are expected to be empty.
+     *
+     * @param[in] cdr The CDR stream.
+     *
+     * @returns `false` if the received data does not match the type.
+     */
+    static bool deserialize_data(
+            ::xtypes::WritableDynamicDataRef data,
+            eprosima::fastcdr::Cdr& cdr);
+
+    /**
+     * @brief Serialize the key members of an *xtypes* data instance into a CDR stream.
+     *        The members of nested structures are looked up too, as the *Fast DDS* Dynamic Types do.
+     *
+     * @param[in] data The data whose key is serialized.
+     *
+     * @param[in] cdr The CDR stream.
+     *
+     * @returns `false` if the type of some key member cannot be serialized.
+     */
+    static bool serialize_key(
+            ::xtypes::ReadableDynamicDataRef data,
+            eprosima::fastcdr::Cdr& cdr);
+
+    /**
+     * @brief Compute the CDR serialized size of an *xtypes* data instance.
+     *
+     * @param[in] data The data to measure.
+     *
+     * @param[in] current_alignment The position in the stream where the data would start.
+     *
+     * @returns The size in bytes, including the alignment padding.
+     */
+    static size_t serialized_size(
+            ::xtypes::ReadableDynamicDataRef data,
+            size_t current_alignment);
+
+    /**
+     * Class members.
+     */
+    ::xtypes::DynamicType::Ptr type_;
+    bool plain_;
+
+    std::vector<char> key_buffer_;
+    std::mutex key_mtx_;
+
+    static utils::Logger logger_;
+};
+
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+#endif //  _IS_SH_FASTDDS__INTERNAL__XTYPESPUBSUBTYPE_HPP_
@@ -0,0 +1,388 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <Conversion.hpp>
+
+#include <fastrtps/types/DynamicData.h>
+#include <fastrtps/types/DynamicDataFactory.h>
+
+#include <xtypes/xtypes.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <new>
+#include <string>
+
+/**
+ * Every heap allocation of the benchmark binary is accounted, so that the benchmarks can report
+ * how many bytes each conversion allocates.
+ */
+static std::atomic<uint64_t> allocated_bytes{0};
+static std::atomic<uint64_t> allocations{0};
+
+void* operator new (
+        std::size_t size)
+{
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete (
+        void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete (
+        void* ptr,
+        std::size_t /*size*/) noexcept
+{
+    std::free(ptr);
+}
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+namespace benchmark_suite {
+
+static const std::string fastdds_sh_unit_test_types = "fastdds_sh_unit_test_types.idl";
+static const std::string fastdds_sh_benchmark_types = "fastdds_sh_benchmark_types.idl";
+
+/**
+ * @brief A benchmarked type, along with the amount of elements put into each of its sequences and maps.
+ */
+struct BenchmarkCase
+{
+    std::string name;
+    std::string idl_file;
+    std::string type_name;
+    size_t collection_size;
+};
+
+static const std::vector<BenchmarkCase> benchmark_cases = {
+    {"flat_struct", fastdds_sh_unit_test_types, "BasicStruct", 0},
+    {"nested_arrays", fastdds_sh_unit_test_types, "NestedArray", 0},
+    {"mixed_struct", fastdds_sh_unit_test_types, "MixedStruct", 3},
+    {"union_and_map", fastdds_sh_unit_test_types, "MyUnionStruct", 8},
+    {"deep_struct", fastdds_sh_benchmark_types, "DeepStruct", 4},
+    {"union", fastdds_sh_benchmark_types, "UnionStruct", 4},
+    {"large_sequences/1024", fastdds_sh_benchmark_types, "LargeSequences", 1024},
+    {"large_sequences/65536", fastdds_sh_benchmark_types, "LargeSequences", 65536},
+    {"string_map/16", fastdds_sh_benchmark_types, "StringMap", 16},
+    {"string_map/1024", fastdds_sh_benchmark_types, "StringMap", 1024},
+    {"matrix", fastdds_sh_benchmark_types, "Matrix", 0}
+};
+
+static const xtypes::DynamicType& get_type(
+        const std::string& idl_file,
+        const std::string& type_name)
+{
+    // Types are owned by their parsing context, which is kept for the whole run
+    static std::map<std::string, xtypes::idl::Context> contexts;
+
+    auto it = contexts.find(idl_file);
+    if (contexts.end() == it)
+    {
+        it = contexts.emplace(idl_file, xtypes::idl::parse_file(idl_file)).first;
+        if (!it->second.success)
+        {
+            std::cerr << "Failed to parse '" << idl_file << "'" << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    auto types = it->second.get_all_scoped_types();
+    if (0 == types.count(type_name))
+    {
+        std::cerr << "Type '" << type_name << "' not found in '" << idl_file << "'" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    return *types[type_name];
+}
+
+static const xtypes::DynamicType& resolve(
+        const xtypes::DynamicType& type)
+{
+    if (type.kind() == xtypes::TypeKind::ALIAS_TYPE)
+    {
+        return static_cast<const xtypes::AliasType&>(type).rget();
+    }
+    return type;
+}
+
+/**
+ * @brief Fill any data instance with values derived from a seed, putting `collection_size`
+ *        elements into each sequence and map (or as many as their bounds allow).
+ */
+static void fill(
+        xtypes::WritableDynamicDataRef data,
+        size_t collection_size,
+        uint32_t seed)
+{
+    const xtypes::DynamicType& type = resolve(data.type());
+
+    switch (type.kind())
+    {
+        case xtypes::TypeKind::BOOLEAN_TYPE:
+            data = (0 == seed % 2);
+            break;
+        case xtypes::TypeKind::CHAR_8_TYPE:
+            data = static_cast<char>('a' + seed % 26);
+            break;
+        case xtypes::TypeKind::CHAR_16_TYPE:
+        case xtypes::TypeKind::WIDE_CHAR_TYPE:
+            data = static_cast<wchar_t>(L'a' + seed % 26);
+            break;
+        case xtypes::TypeKind::UINT_8_TYPE:
+            data = static_cast<uint8_t>(seed);
+            break;
+        case xtypes::TypeKind::INT_8_TYPE:
+            data = static_cast<int8_t>(seed);
+            break;
+        case xtypes::TypeKind::INT_16_TYPE:
+            data = static_cast<int16_t>(seed);
+            break;
+        case xtypes::TypeKind::UINT_16_TYPE:
+            data = static_cast<uint16_t>(seed);
+            break;
+        case xtypes::TypeKind::INT_32_TYPE:
+            data = static_cast<int32_t>(seed);
+            break;
+        case xtypes::TypeKind::UINT_32_TYPE:
+            data = static_cast<uint32_t>(seed);
+            break;
+        case xtypes::TypeKind::INT_64_TYPE:
+            data = static_cast<int64_t>(seed);
+            break;
+        case xtypes::TypeKind::UINT_64_TYPE:
+            data = static_cast<uint64_t>(seed);
+            break;
+        case xtypes::TypeKind::FLOAT_32_TYPE:
+            data = static_cast<float>(seed) * 0.5f;
+            break;
+        case xtypes::TypeKind::FLOAT_64_TYPE:
+            data = static_cast<double>(seed) * 0.5;
+            break;
+        case xtypes::TypeKind::FLOAT_128_TYPE:
+            data = static_cast<long double>(seed) * 0.5l;
+            break;
+        case xtypes::TypeKind::STRING_TYPE:
+            data = "benchmark string #" + std::to_string(seed);
+            break;
+        case xtypes::TypeKind::WSTRING_TYPE:
+            data = L"benchmark wstring #" + std::to_wstring(seed);
+            break;
+        case xtypes::TypeKind::ENUMERATION_TYPE:
+            data = static_cast<uint32_t>(0);
+            break;
+        case xtypes::TypeKind::ARRAY_TYPE:
+            for (size_t idx = 0; idx < data.size(); ++idx)
+            {
+                fill(data[idx], collection_size, seed + static_cast<uint32_t>(idx));
+            }
+            break;
+        case xtypes::TypeKind::SEQUENCE_TYPE:
+        {
+            const xtypes::SequenceType& seq_type = static_cast<const xtypes::SequenceType&>(type);
+            size_t size = collection_size;
+            if (0 < seq_type.bounds() && seq_type.bounds() < size)
+            {
+                size = seq_type.bounds();
+            }
+
+            for (size_t idx = 0; idx < size; ++idx)
+            {
+                xtypes::DynamicData element(seq_type.content_type());
+                fill(element.ref(), collection_size, seed + static_cast<uint32_t>(idx));
+                data.push(element);
+            }
+            break;
+        }
+        case xtypes::TypeKind::MAP_TYPE:
+        {
+            const xtypes::MapType& map_type = static_cast<const xtypes::MapType&>(type);
+            const xtypes::PairType& pair_type = static_cast<const xtypes::PairType&>(map_type.content_type());
+            size_t size = collection_size;
+            if (0 < map_type.bounds() && map_type.bounds() < size)
+            {
+                size = map_type.bounds();
+            }
+
+            for (size_t idx = 0; idx < size; ++idx)
+            {
+                // Keys are derived from the index, so that they are all different
+                xtypes::DynamicData key(pair_type.first());
+                fill(key.ref(), collection_size, static_cast<uint32_t>(idx));
+                fill(data[key], collection_size, seed + static_cast<uint32_t>(idx));
+            }
+            break;
+        }
+        case xtypes::TypeKind::STRUCTURE_TYPE:
+        {
+            const xtypes::StructType& struct_type = static_cast<const xtypes::StructType&>(type);
+            for (size_t idx = 0; idx < struct_type.members().size(); ++idx)
+            {
+                fill(data[idx], collection_size, seed + static_cast<uint32_t>(idx));
+            }
+            break;
+        }
+        case xtypes::TypeKind::UNION_TYPE:
+        {
+            // The last member is usually the most complex one
+            const xtypes::UnionType& union_type = static_cast<const xtypes::UnionType&>(type);
+            fill(data[union_type.get_case_members().back()], collection_size, seed);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Data shared by both conversion directions of a benchmark case.
+ */
+struct ConversionData
+{
+    ConversionData(
+            const BenchmarkCase& benchmark_case)
+        : type(get_type(benchmark_case.idl_file, benchmark_case.type_name))
+        , xtypes_data(type)
+    {
+        fastrtps::types::DynamicTypeBuilder* builder = Conversion::create_builder(type);
+        if (nullptr == builder)
+        {
+            std::cerr << "Cannot create builder for type '" << type.name() << "'" << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        Conversion::prepare_plan(type);
+
+        dds_type = builder->build();
+        dds_data_ptr = fastrtps::types::DynamicData_ptr(
+            fastrtps::types::DynamicDataFactory::get_instance()->create_data(dds_type));
+        dds_data = static_cast<fastrtps::types::DynamicData*>(dds_data_ptr.get());
+
+        fill(xtypes_data.ref(), benchmark_case.collection_size, 1);
+        if (!Conversion::xtypes_to_fastdds(xtypes_data, dds_data))
+        {
+            std::cerr << "Cannot convert data of type '" << type.name() << "'" << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    const xtypes::DynamicType& type;
+    xtypes::DynamicData xtypes_data;
+    fastrtps::types::DynamicType_ptr dds_type;
+    fastrtps::types::DynamicData_ptr dds_data_ptr;
+    fastrtps::types::DynamicData* dds_data;
+};
+
+/**
+ * @brief Report the allocations performed during the timed loop, per converted message.
+ */
+static void report_allocations(
+        benchmark::State& state,
+        uint64_t bytes_before,
+        uint64_t allocations_before)
+{
+    state.SetItemsProcessed(state.iterations());
+    state.counters["bytes_allocated"] = benchmark::Counter(
+        static_cast<double>(allocated_bytes.load() - bytes_before), benchmark::Counter::kAvgIterations);
+    state.counters["allocations"] = benchmark::Counter(
+        static_cast<double>(allocations.load() - allocations_before), benchmark::Counter::kAvgIterations);
+}
+
+/**
+ * @brief As done by the publishers: the *Fast DDS* DynamicData is reused for every message.
+ */
+static void xtypes_to_fastdds(
+        benchmark::State& state,
+        const BenchmarkCase& benchmark_case)
+{
+    ConversionData data(benchmark_case);
+
+    const uint64_t bytes_before = allocated_bytes.load();
+    const uint64_t allocations_before = allocations.load();
+    for (auto _ : state)
+    {
+        bool success = Conversion::xtypes_to_fastdds(data.xtypes_data, data.dds_data);
+        benchmark::DoNotOptimize(success);
+    }
+    report_allocations(state, bytes_before, allocations_before);
+}
+
+/**
+ * @brief As done by the subscribers: a new *xtypes* DynamicData is built for every message.
+ */
+static void fastdds_to_xtypes(
+        benchmark::State& state,
+        const BenchmarkCase& benchmark_case)
+{
+    ConversionData data(benchmark_case);
+
+    const uint64_t bytes_before = allocated_bytes.load();
+    const uint64_t allocations_before = allocations.load();
+    for (auto _ : state)
+    {
+        xtypes::DynamicData output(data.type);
+        bool success = Conversion::fastdds_to_xtypes(data.dds_data, output);
+        benchmark::DoNotOptimize(success);
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, bytes_before, allocations_before);
+}
+
+} //  namespace benchmark_suite
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+int main(
+        int argc,
+        char** argv)
+{
+    using namespace eprosima::is::sh::fastdds::benchmark_suite;
+
+    for (const BenchmarkCase& benchmark_case : benchmark_cases)
+    {
+        benchmark::RegisterBenchmark(
+            ("xtypes_to_fastdds/" + benchmark_case.name).c_str(), xtypes_to_fastdds, benchmark_case);
+        benchmark::RegisterBenchmark(
+            ("fastdds_to_xtypes/" + benchmark_case.name).c_str(), fastdds_to_xtypes, benchmark_case);
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+
+    return EXIT_SUCCESS;
+}
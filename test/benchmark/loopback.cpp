@@ -0,0 +1,545 @@
+/*
+ * Copyright 2019 - present Proyectos y Sistemas de Mantenimiento SL (eProsima).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/**
+ * Loopback benchmark of the Fast DDS System Handle.
+ *
+ * Messages published by the mock middleware are routed by Integration Service to DDS, echoed back
+ * by a DDS participant living in this same process, and routed again to the mock middleware:
+ *
+ *     mock -> [Integration Service] -> bench_<i>_out -> echo -> bench_<i>_back -> [Integration Service] -> mock
+ *
+ * Both participants share the process, so Fast DDS delivers the samples through its intra-process
+ * (or shared memory) transport, and the measured time is mostly spent within Integration Service
+ * and the System Handle.
+ */
+
+#include <is/sh/mock/api.hpp>
+#include <is/core/Instance.hpp>
+
+#include "../../src/Conversion.hpp"
+
+#include <fastrtps/types/DynamicPubSubType.h>
+#include <fastrtps/types/DynamicTypeBuilder.h>
+
+#include <fastdds/dds/domain/DomainParticipantFactory.hpp>
+#include <fastdds/dds/domain/DomainParticipant.hpp>
+#include <fastdds/dds/publisher/Publisher.hpp>
+#include <fastdds/dds/publisher/DataWriter.hpp>
+#include <fastdds/dds/subscriber/Subscriber.hpp>
+#include <fastdds/dds/subscriber/DataReaderListener.hpp>
+#include <fastdds/dds/subscriber/DataReader.hpp>
+#include <fastdds/dds/subscriber/qos/DataReaderQos.hpp>
+#include <fastdds/dds/subscriber/SampleInfo.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+namespace fastdds = eprosima::fastdds;
+
+namespace eprosima {
+namespace is {
+namespace sh {
+namespace fastdds {
+namespace benchmark_suite {
+
+static const std::string payload_type_name = "LoopbackPayload";
+
+static const std::string payload_idl =
+        R"(            struct LoopbackPayload
+            {
+                uint64 stamp;
+                uint32 topic;
+                sequence<octet> data;
+            };)";
+
+/**
+ * @brief Benchmark parameters, taken from the command line.
+ */
+struct Options
+{
+    std::vector<size_t> payload_sizes = {16, 1024, 65536};
+    size_t topics = 1;
+    size_t latency_samples = 10000;
+    std::chrono::seconds throughput_duration = 5s;
+    size_t max_in_flight = 1000;
+    bool direct_serialization = false;
+};
+
+static std::string topic_name(
+        size_t index,
+        const std::string& direction)
+{
+    return "bench_" + std::to_string(index) + "_" + direction;
+}
+
+static uint64_t now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @class EchoParticipant
+ *        DDS participant which writes back each sample received on `bench_<i>_out` to `bench_<i>_back`.
+ */
+class EchoParticipant
+{
+public:
+
+    EchoParticipant(
+            const xtypes::DynamicType& type,
+            size_t topics)
+    {
+        fastrtps::types::DynamicTypeBuilder* builder = Conversion::create_builder(type);
+        if (nullptr == builder)
+        {
+            throw std::runtime_error("Cannot create builder for type " + type.name());
+        }
+
+        type_support_ = fastrtps::types::DynamicPubSubType(builder->build());
+        type_support_.setName(type.name().c_str());
+
+        participant_ = ::fastdds::dds::DomainParticipantFactory::get_instance()->create_participant(
+            0, ::fastdds::dds::PARTICIPANT_QOS_DEFAULT);
+        if (nullptr == participant_)
+        {
+            throw std::runtime_error("Cannot create the echo participant");
+        }
+
+        participant_->register_type(type_support_);
+        publisher_ = participant_->create_publisher(::fastdds::dds::PUBLISHER_QOS_DEFAULT);
+        subscriber_ = participant_->create_subscriber(::fastdds::dds::SUBSCRIBER_QOS_DEFAULT);
+
+        ::fastdds::dds::DataReaderQos datareader_qos = ::fastdds::dds::DATAREADER_QOS_DEFAULT;
+        datareader_qos.reliability().kind = ::fastdds::dds::RELIABLE_RELIABILITY_QOS;
+
+        for (size_t i = 0; i < topics; ++i)
+        {
+            auto echo = std::make_unique<Echo>(type_support_);
+
+            echo->in_topic = participant_->create_topic(
+                topic_name(i, "out"), type_support_.getName(), ::fastdds::dds::TOPIC_QOS_DEFAULT);
+            echo->out_topic = participant_->create_topic(
+                topic_name(i, "back"), type_support_.getName(), ::fastdds::dds::TOPIC_QOS_DEFAULT);
+            echo->writer = publisher_->create_datawriter(
+                echo->out_topic, ::fastdds::dds::DATAWRITER_QOS_DEFAULT);
+            echo->reader = subscriber_->create_datareader(echo->in_topic, datareader_qos, echo.get());
+
+            if (nullptr == echo->writer || nullptr == echo->reader)
+            {
+                throw std::runtime_error("Cannot create the echo entities for topic " + topic_name(i, "out"));
+            }
+
+            echoes_.emplace_back(std::move(echo));
+        }
+    }
+
+    ~EchoParticipant()
+    {
+        for (const std::unique_ptr<Echo>& echo : echoes_)
+        {
+            subscriber_->delete_datareader(echo->reader);
+            publisher_->delete_datawriter(echo->writer);
+            participant_->delete_topic(echo->in_topic);
+            participant_->delete_topic(echo->out_topic);
+        }
+
+        participant_->delete_subscriber(subscriber_);
+        participant_->delete_publisher(publisher_);
+        participant_->unregister_type(type_support_.getName());
+        ::fastdds::dds::DomainParticipantFactory::get_instance()->delete_participant(participant_);
+    }
+
+private:
+
+    struct Echo : public ::fastdds::dds::DataReaderListener
+    {
+        Echo(
+                fastrtps::types::DynamicPubSubType& pubsub_type)
+            : type_support(pubsub_type)
+        {
+        }
+
+        void on_data_available(
+                ::fastdds::dds::DataReader* /*reader*/) override
+        {
+            void* sample = type_support.createData();
+            ::fastdds::dds::SampleInfo info;
+
+            while (fastrtps::types::ReturnCode_t::RETCODE_OK == reader->take_next_sample(sample, &info))
+            {
+                if (info.valid_data)
+                {
+                    writer->write(sample);
+                }
+            }
+
+            type_support.deleteData(sample);
+        }
+
+        fastrtps::types::DynamicPubSubType& type_support;
+        ::fastdds::dds::Topic* in_topic = nullptr;
+        ::fastdds::dds::Topic* out_topic = nullptr;
+        ::fastdds::dds::DataReader* reader = nullptr;
+        ::fastdds::dds::DataWriter* writer = nullptr;
+    };
+
+    fastrtps::types::DynamicPubSubType type_support_;
+    ::fastdds::dds::DomainParticipant* participant_ = nullptr;
+    ::fastdds::dds::Publisher* publisher_ = nullptr;
+    ::fastdds::dds::Subscriber* subscriber_ = nullptr;
+    std::vector<std::unique_ptr<Echo> > echoes_;
+};
+
+static std::string gen_config_yaml(
+        const Options& options)
+{
+    std::string s;
+    s += "types:\n";
+    s += "    idls:\n";
+    s += "        - >\n";
+    s += payload_idl + "\n";
+
+    s += "systems:\n";
+    s += "    dds: { type: fastdds }\n";
+    s += "    mock: { type: mock }\n";
+
+    s += "routes:\n";
+    s += "    mock_to_dds: { from: mock, to: dds }\n";
+    s += "    dds_to_mock: { from: dds, to: mock }\n";
+
+    const std::string dds_options = options.direct_serialization ? ", direct_serialization: true" : "";
+
+    s += "topics:\n";
+    for (size_t i = 0; i < options.topics; ++i)
+    {
+        s += "    " + topic_name(i, "out") + ": { type: " + payload_type_name + ", route: mock_to_dds"
+                + dds_options + " }\n";
+        s += "    " + topic_name(i, "back") + ": { type: " + payload_type_name + ", route: dds_to_mock"
+                + dds_options + " }\n";
+    }
+    return s;
+}
+
+/**
+ * @brief Collects the messages coming back to the mock middleware.
+ */
+class Receiver
+{
+public:
+
+    void on_message(
+            const xtypes::DynamicData& message)
+    {
+        const uint64_t latency = now_ns() - message["stamp"].value<uint64_t>();
+
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (record_latencies_)
+        {
+            latencies_.push_back(latency);
+        }
+        ++received_;
+        cv_.notify_all();
+    }
+
+    bool wait_for(
+            uint64_t count,
+            std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        return cv_.wait_for(lock, timeout, [&]()
+                       {
+                           return received_ >= count;
+                       });
+    }
+
+    void reset(
+            bool record_latencies)
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        record_latencies_ = record_latencies;
+        latencies_.clear();
+        received_ = 0;
+    }
+
+    uint64_t received()
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        return received_;
+    }
+
+    std::vector<uint64_t> latencies()
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        return latencies_;
+    }
+
+private:
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool record_latencies_ = false;
+    std::vector<uint64_t> latencies_;
+    uint64_t received_ = 0;
+};
+
+static double percentile_us(
+        const std::vector<uint64_t>& sorted,
+        double percentile)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+
+    size_t rank = static_cast<size_t>(percentile * static_cast<double>(sorted.size()));
+    return static_cast<double>(sorted[std::min(rank, sorted.size() - 1)]) / 1000.0;
+}
+
+static void run(
+        const Options& options,
+        const xtypes::DynamicType& type,
+        Receiver& receiver,
+        size_t payload_size)
+{
+    std::vector<xtypes::DynamicData> messages;
+    for (size_t i = 0; i < options.topics; ++i)
+    {
+        xtypes::DynamicData message(type);
+        message["topic"] = static_cast<uint32_t>(i);
+        for (size_t b = 0; b < payload_size; ++b)
+        {
+            message["data"].push(static_cast<uint8_t>(b));
+        }
+        messages.emplace_back(std::move(message));
+    }
+
+    auto publish = [&](size_t index)
+            {
+                const size_t topic = index % options.topics;
+                messages[topic]["stamp"] = now_ns();
+                is::sh::mock::publish_message(topic_name(topic, "out"), messages[topic]);
+            };
+
+    // Latency: a single message in flight at a time, round robin over the topics
+    receiver.reset(true);
+    size_t lost = 0;
+    for (size_t i = 0; i < options.latency_samples; ++i)
+    {
+        publish(i);
+        if (!receiver.wait_for(i + 1 - lost, 1000ms))
+        {
+            ++lost;
+        }
+    }
+
+    std::vector<uint64_t> latencies = receiver.latencies();
+    std::sort(latencies.begin(), latencies.end());
+
+    // Throughput: publish as fast as possible, with a bounded amount of messages in flight
+    receiver.reset(false);
+    uint64_t sent = 0;
+    const auto start = std::chrono::steady_clock::now();
+    const auto end = start + options.throughput_duration;
+    while (std::chrono::steady_clock::now() < end)
+    {
+        if (!receiver.wait_for(sent + 1 > options.max_in_flight ? sent + 1 - options.max_in_flight : 0, 100ms))
+        {
+            // Messages were lost; do not wait for them anymore
+            sent = receiver.received() + options.max_in_flight - 1;
+            continue;
+        }
+        publish(sent++);
+    }
+    receiver.wait_for(sent, 1000ms);
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const uint64_t received = receiver.received();
+
+    std::cout << std::fixed << std::setprecision(1)
+              << std::setw(10) << payload_size
+              << std::setw(8) << options.topics
+              << std::setw(12) << percentile_us(latencies, 0.5)
+              << std::setw(12) << percentile_us(latencies, 0.99)
+              << std::setw(12) << percentile_us(latencies, 0.999)
+              << std::setw(10) << lost
+              << std::setw(14) << static_cast<double>(received) / elapsed
+              << std::setw(14) << static_cast<double>(received * payload_size) / elapsed / (1024 * 1024)
+              << std::endl;
+}
+
+static void usage(
+        const char* program)
+{
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --payload <bytes>[,<bytes>...]  Payload sizes to test (default: 16,1024,65536)\n"
+              << "  --topics <count>                Number of topics, used round robin (default: 1)\n"
+              << "  --samples <count>               Messages sent to measure the latency (default: 10000)\n"
+              << "  --duration <seconds>            Duration of the throughput test (default: 5)\n"
+              << "  --in-flight <count>             Maximum messages in flight in the throughput test (default: 1000)\n"
+              << "  --direct                        Use the direct serialization mode\n";
+}
+
+static bool parse_options(
+        int argc,
+        char** argv,
+        Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+
+        if ("--direct" == arg)
+        {
+            options.direct_serialization = true;
+        }
+        else if ("--payload" == arg && has_value)
+        {
+            options.payload_sizes.clear();
+            std::stringstream sizes(argv[++i]);
+            std::string size;
+            while (std::getline(sizes, size, ','))
+            {
+                options.payload_sizes.push_back(std::stoul(size));
+            }
+        }
+        else if ("--topics" == arg && has_value)
+        {
+            options.topics = std::max<size_t>(1, std::stoul(argv[++i]));
+        }
+        else if ("--samples" == arg && has_value)
+        {
+            options.latency_samples = std::stoul(argv[++i]);
+        }
+        else if ("--duration" == arg && has_value)
+        {
+            options.throughput_duration = std::chrono::seconds(std::stoul(argv[++i]));
+        }
+        else if ("--in-flight" == arg && has_value)
+        {
+            options.max_in_flight = std::max<size_t>(1, std::stoul(argv[++i]));
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} //  namespace benchmark_suite
+} //  namespace fastdds
+} //  namespace sh
+} //  namespace is
+} //  namespace eprosima
+
+int main(
+        int argc,
+        char** argv)
+{
+    using namespace eprosima::is::sh::fastdds::benchmark_suite;
+    namespace is = eprosima::is;
+
+    Options options;
+    try
+    {
+        if (!parse_options(argc, argv, options))
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    catch (const std::exception& /*e*/)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    is::core::InstanceHandle instance = is::run_instance(YAML::Load(gen_config_yaml(options)));
+    if (!instance)
+    {
+        std::cerr << "Failed to start Integration Service" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const eprosima::xtypes::DynamicType& type = *instance.type_registry("mock")->at(payload_type_name);
+
+    Receiver receiver;
+    for (size_t i = 0; i < options.topics; ++i)
+    {
+        is::sh::mock::subscribe(
+            topic_name(i, "back"),
+            [&receiver](const eprosima::xtypes::DynamicData& message)
+            {
+                receiver.on_message(message);
+            });
+    }
+
+    {
+        EchoParticipant echo(type, options.topics);
+
+        // Wait for discovery: each topic must echo a first message
+        std::vector<eprosima::xtypes::DynamicData> warmup(options.topics, eprosima::xtypes::DynamicData(type));
+        for (size_t i = 0; i < options.topics; ++i)
+        {
+            receiver.reset(false);
+            bool matched = false;
+            for (int attempt = 0; attempt < 50 && !matched; ++attempt)
+            {
+                is::sh::mock::publish_message(topic_name(i, "out"), warmup[i]);
+                matched = receiver.wait_for(1, 100ms);
+            }
+
+            if (!matched)
+            {
+                std::cerr << "Topic " << topic_name(i, "out") << " did not match" << std::endl;
+                instance.quit().wait_for(1s);
+                return EXIT_FAILURE;
+            }
+        }
+
+        std::cout << std::setw(10) << "payload"
+                  << std::setw(8) << "topics"
+                  << std::setw(12) << "p50 (us)"
+                  << std::setw(12) << "p99 (us)"
+                  << std::setw(12) << "p999 (us)"
+                  << std::setw(10) << "lost"
+                  << std::setw(14) << "msg/s"
+                  << std::setw(14) << "MiB/s"
+                  << std::endl;
+
+        for (size_t payload_size : options.payload_sizes)
+        {
+            run(options, type, receiver, payload_size);
+        }
+    }
+
+    instance.quit().wait_for(1s);
+    return EXIT_SUCCESS;
+}
@@ -16,6 +16,8 @@
  */
 
 #include <Conversion.hpp>
+#include <SystemHandle.hpp>
+#include <XTypesPubSubType.hpp>
 
 #include <fastrtps/types/DynamicData.h>
 #include <fastrtps/types/DynamicDataFactory.h>
@@ -24,6 +26,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <thread>
+#include <vector>
+
 namespace fastdds = eprosima::fastdds;
 
 namespace eprosima {
@@ -200,6 +206,105 @@ static void check_nested_array(
     }
 }
 
+static void fill_primitive_collections(
+        xtypes::WritableDynamicDataRef xtypes_data)
+{
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        xtypes_data["my_float_seq"].push(static_cast<float>(i) * 0.5f);
+    }
+
+    for (size_t i = 0; i < 256; ++i)
+    {
+        xtypes_data["my_octet_seq"].push(static_cast<uint8_t>(i));
+    }
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+        for (size_t j = 0; j < 8; ++j)
+        {
+            xtypes_data["my_int16_arr"][i][j] = static_cast<int16_t>((i * 8) + j - 8);
+        }
+    }
+
+    for (size_t i = 0; i < 16; ++i)
+    {
+        xtypes_data["my_uint64_arr"][i] = static_cast<uint64_t>(1) << (i * 3);
+    }
+}
+
+static void check_primitive_collections(
+        fastrtps::types::DynamicData* dds_data)
+{
+    fastrtps::types::DynamicData* float_seq =
+            dds_data->loan_value(dds_data->get_member_id_by_name("my_float_seq"));
+    ASSERT_EQ(float_seq->get_item_count(), 1000u);
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQ(float_seq->get_float32_value(i), static_cast<float>(i) * 0.5f);
+    }
+    dds_data->return_loaned_value(float_seq);
+
+    fastrtps::types::DynamicData* octet_seq =
+            dds_data->loan_value(dds_data->get_member_id_by_name("my_octet_seq"));
+    ASSERT_EQ(octet_seq->get_item_count(), 256u);
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        ASSERT_EQ(octet_seq->get_uint8_value(i), static_cast<uint8_t>(i));
+    }
+    dds_data->return_loaned_value(octet_seq);
+
+    fastrtps::types::DynamicData* int16_arr =
+            dds_data->loan_value(dds_data->get_member_id_by_name("my_int16_arr"));
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        for (uint32_t j = 0; j < 8; ++j)
+        {
+            fastrtps::types::MemberId idx = int16_arr->get_array_index({i, j});
+            ASSERT_EQ(int16_arr->get_int16_value(idx), static_cast<int16_t>((i * 8) + j - 8));
+        }
+    }
+    dds_data->return_loaned_value(int16_arr);
+
+    fastrtps::types::DynamicData* uint64_arr =
+            dds_data->loan_value(dds_data->get_member_id_by_name("my_uint64_arr"));
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        fastrtps::types::MemberId idx = uint64_arr->get_array_index({i});
+        ASSERT_EQ(uint64_arr->get_uint64_value(idx), static_cast<uint64_t>(1) << (i * 3));
+    }
+    dds_data->return_loaned_value(uint64_arr);
+}
+
+static void check_primitive_collections(
+        xtypes::ReadableDynamicDataRef xtypes_data)
+{
+    ASSERT_EQ(xtypes_data["my_float_seq"].size(), 1000u);
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQ(xtypes_data["my_float_seq"][i].value<float>(), static_cast<float>(i) * 0.5f);
+    }
+
+    ASSERT_EQ(xtypes_data["my_octet_seq"].size(), 256u);
+    for (size_t i = 0; i < 256; ++i)
+    {
+        ASSERT_EQ(xtypes_data["my_octet_seq"][i].value<uint8_t>(), static_cast<uint8_t>(i));
+    }
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+        for (size_t j = 0; j < 8; ++j)
+        {
+            ASSERT_EQ(xtypes_data["my_int16_arr"][i][j].value<int16_t>(), static_cast<int16_t>((i * 8) + j - 8));
+        }
+    }
+
+    for (size_t i = 0; i < 16; ++i)
+    {
+        ASSERT_EQ(xtypes_data["my_uint64_arr"][i].value<uint64_t>(), static_cast<uint64_t>(1) << (i * 3));
+    }
+}
+
 static void fill_mixed_struct(
         xtypes::DynamicData& xtypes_data)
 {
@@ -551,6 +656,31 @@ static void check_union_struct(
     check_basic_struct(xtypes_data["my_map"].at(key));
 }
 
+static void check_direct_serialization(
+        const xtypes::DynamicType& type,
+        fastrtps::types::DynamicType_ptr dds_type,
+        xtypes::DynamicData& xtypes_data,
+        fastrtps::types::DynamicData* dds_data,
+        xtypes::DynamicData& wayback)
+{
+    fastrtps::types::DynamicPubSubType dynamic_type_support(dds_type);
+    XTypesPubSubType xtypes_type_support(type, dds_type);
+
+    fastrtps::rtps::SerializedPayload_t dynamic_payload(
+        dynamic_type_support.getSerializedSizeProvider(dds_data)());
+    ASSERT_TRUE(dynamic_type_support.serialize(dds_data, &dynamic_payload));
+
+    fastrtps::rtps::SerializedPayload_t xtypes_payload(
+        xtypes_type_support.getSerializedSizeProvider(&xtypes_data)());
+    ASSERT_TRUE(xtypes_type_support.serialize(&xtypes_data, &xtypes_payload));
+
+    // Both type supports must produce the same data on the wire
+    ASSERT_EQ(dynamic_payload.length, xtypes_payload.length);
+    ASSERT_EQ(0, std::memcmp(dynamic_payload.data, xtypes_payload.data, xtypes_payload.length));
+
+    ASSERT_TRUE(xtypes_type_support.deserialize(&dynamic_payload, &wayback));
+}
+
 TEST(FastDDSUnitary, Convert_between_Integration_Service_and_DDS__basic_type)
 {
     xtypes::idl::Context context = xtypes::idl::parse_file(fastdds_sh_unit_test_types);
@@ -650,6 +780,37 @@ TEST(FastDDSUnitary, Convert_between_Integration_Service_and_DDS__nested_array)
     check_nested_array(wayback["my_arr_arr"]);
 }
 
+TEST(FastDDSUnitary, Convert_between_Integration_Service_and_DDS__primitive_collections)
+{
+    xtypes::idl::Context context = xtypes::idl::parse_file(fastdds_sh_unit_test_types);
+    ASSERT_TRUE(context.success);
+
+    auto result = context.get_all_scoped_types();
+    ASSERT_FALSE(result.empty());
+
+    const xtypes::DynamicType* primitive_collections = result["PrimitiveCollections"].get();
+    ASSERT_NE(primitive_collections, nullptr);
+    // Convert type from Integration Service to dds
+    fastrtps::types::DynamicTypeBuilder* builder = Conversion::create_builder(*primitive_collections);
+    ASSERT_NE(builder, nullptr);
+    fastrtps::types::DynamicType_ptr dds_type = builder->build();
+    fastrtps::types::DynamicData_ptr dds_data_ptr(
+        fastrtps::types::DynamicDataFactory::get_instance()->create_data(dds_type));
+    fastrtps::types::DynamicData* dds_data =
+            static_cast<fastrtps::types::DynamicData*>(dds_data_ptr.get());
+    xtypes::DynamicData xtypes_data(*primitive_collections);
+    // Fill xtypes_data
+    fill_primitive_collections(xtypes_data);
+    // Convert to dds_data
+    Conversion::xtypes_to_fastdds(xtypes_data, dds_data);
+    // Check data in dds_data
+    check_primitive_collections(dds_data);
+    // The other way
+    xtypes::DynamicData wayback(*primitive_collections);
+    Conversion::fastdds_to_xtypes(dds_data, wayback);
+    check_primitive_collections(wayback);
+}
+
 TEST(FastDDSUnitary, Convert_between_Integration_Service_and_DDS__mixed_struct)
 {
     xtypes::idl::Context context = xtypes::idl::parse_file(fastdds_sh_unit_test_types);
@@ -773,6 +934,371 @@ TEST(FastDDSUnitary, Convert_between_Integration_Service_and_DDS__namespaced_typ
     check_basic_struct(wayback["basic"]);
 }
 
+TEST(FastDDSUnitary, Direct_serialization_of_Integration_Service_data__basic_type)
+{
+    xtypes::idl::Context context = xtypes::idl::parse_file(fastdds_sh_unit_test_types);
+    ASSERT_TRUE(context.success);
+
+    auto result = context.get_all_scoped_types();
+    ASSERT_FALSE(result.empty());
+
+    const xtypes::DynamicType* basic_struct = result["BasicStruct"].get();
+    ASSERT_NE(basic_struct, nullptr);
+    fastrtps::types::DynamicTypeBuilder* builder = Conversion::create_builder(*basic_struct);
+    ASSERT_NE(builder, nullptr);
+    fastrtps::types::DynamicType_ptr dds_struct = builder->build();
+    fastrtps::types::DynamicData_ptr dds_data_ptr(
+        fastrtps::types::DynamicDataFactory::get_instance()->create_data(dds_struct));
+    fastrtps::types::DynamicData* dds_data =
+            static_cast<fastrtps::types::DynamicData*>(dds_data_ptr.get());
+    xtypes::DynamicData xtypes_data(*basic_struct);
+    fill_basic_struct(xtypes_data);
+    Conversion::xtypes_to_fastdds(xtypes_data, dds_data);
+    // Serialize with both type supports and read it back
+    xtypes::DynamicData wayback(*basic_struct);
+    check_direct_serialization(*basic_struct, dds_struct, xtypes_data, dds_data, wayback);
+    check_basic_struct(wayback);
+}
+
+TEST(FastDDSUnitary, Direct_serialization_of_Integration_Service_data__mixed_struct)
+{
+    xtypes::idl::Context context = xtypes::idl::parse_file(fastdds_sh_unit_test_types);
+    ASSERT_TRUE(context.success);
+
+    auto result = context.get_all_scoped_types();
+    ASSERT_FALSE(result.empty());
+
+    const xtypes::DynamicType* mixed_struct = result["MixedStruct"].get();
+    ASSERT_NE(mixed_struct, nullptr);
+    fastrtps::types::DynamicTypeBuilder* builder = Conversion::create_builder(*mixed_struct);
+    ASSERT_NE(builder, nullptr);
+    fastrtps::types::DynamicType_ptr dds_struct = builder->build();
+    fastrtps::types::DynamicData_ptr dds_data_ptr(
+        fastrtps::types::DynamicDataFactory::get_instance()->create_data(dds_struct));
+    fastrtps::types::DynamicData* dds_data =
+            static_cast<fastrtps::types::DynamicData*>(dds_data_ptr.get());
+    xtypes::DynamicData xtypes_data(*mixed_struct);
+    fill_mixed_struct(xtypes_data);
+    Conversion::xtypes_to_fastdds(xtypes_data, dds_data);
+    // Serialize with both type supports and read it back
+    xtypes::DynamicData wayback(*mixed_struct);
+    check_direct_serialization(*mixed_struct, dds_struct, xtypes_data, dds_data, wayback);
+    check_mixed_struct(wayback);
+}
+
+TEST(FastDDSUnitary, Direct_serialization_of_Integration_Service_data__union_struct)
+{
+    xtypes::idl::Context context = xtypes::idl::parse_file(fastdds_sh_unit_test_types);
+    ASSERT_TRUE(context.success);
+
+    auto result = context.get_all_scoped_types();
+    ASSERT_FALSE(result.empty());
+
+    const xtypes::DynamicType* union_struct = result["MyUnionStruct"].get();
+    ASSERT_NE(union_struct, nullptr);
+    fastrtps::types::DynamicTypeBuilder* builder = Conversion::create_builder(*union_struct);
+    ASSERT_NE(builder, nullptr);
+    fastrtps::types::DynamicType_ptr dds_struct = builder->build();
+
+    // Each case of the union, along with the map
+    for (uint8_t disc : {0, 1, 3})
+    {
+        fastrtps::types::DynamicData_ptr dds_data_ptr(
+            fastrtps::types::DynamicDataFactory::get_instance()->create_data(dds_struct));
+        fastrtps::types::DynamicData* dds_data =
+                static_cast<fastrtps::types::DynamicData*>(dds_data_ptr.get());
+        xtypes::DynamicData xtypes_data(*union_struct);
+        fill_union_struct(xtypes_data, disc);
+        Conversion::xtypes_to_fastdds(xtypes_data, dds_data);
+        // Serialize with both type supports and read it back
+        xtypes::DynamicData wayback(*union_struct);
+        check_direct_serialization(*union_struct, dds_struct, xtypes_data, dds_data, wayback);
+        check_union_struct(wayback);
+    }
+}
+
+TEST(FastDDSUnitary, Reuse_Integration_Service_data_for_several_conversions)
+{
+    xtypes::idl::Context context = xtypes::idl::parse_file(fastdds_sh_unit_test_types);
+    ASSERT_TRUE(context.success);
+
+    auto result = context.get_all_scoped_types();
+    ASSERT_FALSE(result.empty());
+
+    // Only types without sequences nor maps can be overwritten by a new conversion
+    ASSERT_TRUE(Conversion::is_reusable(*result["BasicStruct"]));
+    ASSERT_TRUE(Conversion::is_reusable(*result["NestedArray"]));
+    ASSERT_FALSE(Conversion::is_reusable(*result["NestedSequence"]));
+    ASSERT_FALSE(Conversion::is_reusable(*result["PrimitiveCollections"]));
+    ASSERT_FALSE(Conversion::is_reusable(*result["MixedStruct"]));
+    ASSERT_FALSE(Conversion::is_reusable(*result["MyUnionStruct"]));
+
+    const xtypes::DynamicType* basic_struct = result["BasicStruct"].get();
+    fastrtps::types::DynamicTypeBuilder* builder = Conversion::create_builder(*basic_struct);
+    ASSERT_NE(builder, nullptr);
+    fastrtps::types::DynamicType_ptr dds_struct = builder->build();
+    fastrtps::types::DynamicData_ptr dds_data_ptr(
+        fastrtps::types::DynamicDataFactory::get_instance()->create_data(dds_struct));
+    fastrtps::types::DynamicData* dds_data =
+            static_cast<fastrtps::types::DynamicData*>(dds_data_ptr.get());
+    xtypes::DynamicData xtypes_data(*basic_struct);
+    fill_basic_struct(xtypes_data);
+    Conversion::xtypes_to_fastdds(xtypes_data, dds_data);
+    // Convert a first message, change it and convert the original one again into the same output
+    xtypes::DynamicData wayback(*basic_struct);
+    Conversion::fastdds_to_xtypes(dds_data, wayback);
+    wayback["my_int32"] = int32_t(0);
+    wayback["my_string"] = std::string("overwritten");
+    Conversion::fastdds_to_xtypes(dds_data, wayback);
+    check_basic_struct(wayback);
+}
+
+TEST(FastDDSUnitary, Take_into_reused_samples_only_for_reusable_types)
+{
+    xtypes::idl::Context context = xtypes::idl::parse_file(fastdds_sh_unit_test_types);
+    ASSERT_TRUE(context.success);
+
+    auto result = context.get_all_scoped_types();
+    ASSERT_FALSE(result.empty());
+
+    // A sample of a type with sequences keeps the elements of the previous take
+    const xtypes::DynamicType* collections = result["PrimitiveCollections"].get();
+    ASSERT_NE(collections, nullptr);
+    ASSERT_FALSE(Conversion::is_reusable(*collections));
+    fastrtps::types::DynamicType_ptr dds_collections = Conversion::create_builder(*collections)->build();
+    XTypesPubSubType collections_type_support(*collections, dds_collections);
+
+    xtypes::DynamicData first(*collections);
+    fill_primitive_collections(first);
+    fastrtps::rtps::SerializedPayload_t first_payload(
+        collections_type_support.getSerializedSizeProvider(&first)());
+    ASSERT_TRUE(collections_type_support.serialize(&first, &first_payload));
+
+    xtypes::DynamicData second(*collections);
+    second["my_float_seq"].push(1.5f);
+    fastrtps::rtps::SerializedPayload_t second_payload(
+        collections_type_support.getSerializedSizeProvider(&second)());
+    ASSERT_TRUE(collections_type_support.serialize(&second, &second_payload));
+
+    xtypes::DynamicData reused(*collections);
+    ASSERT_TRUE(collections_type_support.deserialize(&first_payload, &reused));
+    ASSERT_TRUE(collections_type_support.deserialize(&second_payload, &reused));
+    ASSERT_NE(reused["my_float_seq"].size(), 1u);
+
+    xtypes::DynamicData fresh(*collections);
+    ASSERT_TRUE(collections_type_support.deserialize(&second_payload, &fresh));
+    ASSERT_TRUE(fresh == second);
+
+    // A sample of a type without sequences nor maps is fully overwritten by the next take
+    const xtypes::DynamicType* nested_array = result["NestedArray"].get();
+    ASSERT_NE(nested_array, nullptr);
+    ASSERT_TRUE(Conversion::is_reusable(*nested_array));
+    fastrtps::types::DynamicType_ptr dds_nested_array = Conversion::create_builder(*nested_array)->build();
+    XTypesPubSubType nested_array_type_support(*nested_array, dds_nested_array);
+
+    xtypes::DynamicData filled(*nested_array);
+    fill_nested_array(filled["my_arr_arr"]);
+    fastrtps::rtps::SerializedPayload_t filled_payload(
+        nested_array_type_support.getSerializedSizeProvider(&filled)());
+    ASSERT_TRUE(nested_array_type_support.serialize(&filled, &filled_payload));
+
+    xtypes::DynamicData empty(*nested_array);
+    fastrtps::rtps::SerializedPayload_t empty_payload(
+        nested_array_type_support.getSerializedSizeProvider(&empty)());
+    ASSERT_TRUE(nested_array_type_support.serialize(&empty, &empty_payload));
+
+    xtypes::DynamicData reused_array(*nested_array);
+    ASSERT_TRUE(nested_array_type_support.deserialize(&filled_payload, &reused_array));
+    ASSERT_TRUE(nested_array_type_support.deserialize(&empty_payload, &reused_array));
+    ASSERT_TRUE(reused_array == empty);
+}
+
+TEST(FastDDSUnitary, Create_builders_from_several_threads)
+{
+    xtypes::idl::Context context = xtypes::idl::parse_file(fastdds_sh_unit_test_types);
+    ASSERT_TRUE(context.success);
+
+    auto result = context.get_all_scoped_types();
+    ASSERT_FALSE(result.empty());
+
+    const xtypes::DynamicType* mixed_struct = result["MixedStruct"].get();
+    ASSERT_NE(mixed_struct, nullptr);
+
+    // All the threads shall get the same builder, whichever of them registered it
+    std::vector<fastrtps::types::DynamicTypeBuilder*> builders(8, nullptr);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < builders.size(); ++i)
+    {
+        threads.emplace_back([&builders, mixed_struct, i]()
+                {
+                    builders[i] = Conversion::create_builder(*mixed_struct);
+                    Conversion::prepare_plan(*mixed_struct);
+                });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_NE(builders[0], nullptr);
+    for (fastrtps::types::DynamicTypeBuilder* builder : builders)
+    {
+        ASSERT_EQ(builders[0], builder);
+    }
+    ASSERT_EQ(builders[0], Conversion::create_builder(*mixed_struct));
+}
+
+TEST(FastDDSUnitary, Compute_instance_handles_of_keyed_types)
+{
+    xtypes::idl::Context context = xtypes::idl::parse_file(fastdds_sh_unit_test_types);
+    ASSERT_TRUE(context.success);
+
+    auto result = context.get_all_scoped_types();
+    ASSERT_FALSE(result.empty());
+
+    const xtypes::DynamicType* keyed_struct = result["KeyedStruct"].get();
+    ASSERT_NE(keyed_struct, nullptr);
+    fastrtps::types::DynamicTypeBuilder* builder = Conversion::create_builder(*keyed_struct);
+    ASSERT_NE(builder, nullptr);
+    fastrtps::types::DynamicType_ptr dds_struct = builder->build();
+
+    // The @key members must make both type supports keyed
+    fastrtps::types::DynamicPubSubType dynamic_type_support(dds_struct);
+    XTypesPubSubType xtypes_type_support(*keyed_struct, dds_struct);
+    ASSERT_TRUE(dynamic_type_support.m_isGetKeyDefined);
+    ASSERT_TRUE(xtypes_type_support.m_isGetKeyDefined);
+
+    xtypes::DynamicData xtypes_data(*keyed_struct);
+    xtypes_data["my_id"] = int32_t(7);
+    xtypes_data["my_name"] = "sensor";
+    xtypes_data["my_value"] = 1.5;
+
+    fastrtps::types::DynamicData_ptr dds_data_ptr(
+        fastrtps::types::DynamicDataFactory::get_instance()->create_data(dds_struct));
+    fastrtps::types::DynamicData* dds_data =
+            static_cast<fastrtps::types::DynamicData*>(dds_data_ptr.get());
+    Conversion::xtypes_to_fastdds(xtypes_data, dds_data);
+
+    // Both type supports must compute the same instance handle
+    fastrtps::rtps::InstanceHandle_t dynamic_handle;
+    fastrtps::rtps::InstanceHandle_t xtypes_handle;
+    ASSERT_TRUE(dynamic_type_support.getKey(dds_data, &dynamic_handle));
+    ASSERT_TRUE(xtypes_type_support.getKey(&xtypes_data, &xtypes_handle));
+    ASSERT_EQ(dynamic_handle, xtypes_handle);
+
+    // Only the key members tell the instances apart
+    xtypes::DynamicData same_instance(xtypes_data);
+    same_instance["my_value"] = 2.5;
+    fastrtps::rtps::InstanceHandle_t same_handle;
+    ASSERT_TRUE(xtypes_type_support.getKey(&same_instance, &same_handle));
+    ASSERT_EQ(xtypes_handle, same_handle);
+
+    xtypes::DynamicData other_instance(xtypes_data);
+    other_instance["my_id"] = int32_t(8);
+    fastrtps::rtps::InstanceHandle_t other_handle;
+    ASSERT_TRUE(xtypes_type_support.getKey(&other_instance, &other_handle));
+    ASSERT_NE(xtypes_handle, other_handle);
+}
+
+TEST(FastDDSUnitary, Do_not_loan_samples_of_keyed_types)
+{
+    xtypes::idl::Context context = xtypes::idl::parse_file(fastdds_sh_unit_test_types);
+    ASSERT_TRUE(context.success);
+
+    auto result = context.get_all_scoped_types();
+    ASSERT_FALSE(result.empty());
+
+    const xtypes::DynamicType* plain_struct = result["PlainStruct"].get();
+    ASSERT_NE(plain_struct, nullptr);
+    fastrtps::types::DynamicType_ptr dds_plain_struct = Conversion::create_builder(*plain_struct)->build();
+    XTypesPubSubType plain_type_support(*plain_struct, dds_plain_struct);
+    ASSERT_FALSE(plain_type_support.m_isGetKeyDefined);
+    ASSERT_TRUE(plain_type_support.plain());
+
+    // The loaned samples are raw CDR buffers, which getKey cannot read
+    const xtypes::DynamicType* keyed_plain_struct = result["KeyedPlainStruct"].get();
+    ASSERT_NE(keyed_plain_struct, nullptr);
+    fastrtps::types::DynamicType_ptr dds_keyed_plain_struct = Conversion::create_builder(*keyed_plain_struct)->build();
+    XTypesPubSubType keyed_type_support(*keyed_plain_struct, dds_keyed_plain_struct);
+    ASSERT_TRUE(keyed_type_support.m_isGetKeyDefined);
+    ASSERT_FALSE(keyed_type_support.plain());
+
+    xtypes::DynamicData xtypes_data(*keyed_plain_struct);
+    std::vector<uint8_t> sample(keyed_type_support.m_typeSize);
+    ASSERT_FALSE(keyed_type_support.serialize_plain(xtypes_data, sample.data()));
+}
+
+TEST(FastDDSUnitary, Access_members_through_compiled_paths)
+{
+    xtypes::idl::Context context = xtypes::idl::parse_file(fastdds_sh_unit_test_types);
+    ASSERT_TRUE(context.success);
+
+    auto result = context.get_all_scoped_types();
+    ASSERT_FALSE(result.empty());
+
+    const xtypes::DynamicType* union_struct = result["MyUnionStruct"].get();
+    ASSERT_NE(union_struct, nullptr);
+
+    // The first token of the path names the type itself
+    MemberPath root;
+    ASSERT_TRUE(Conversion::compile_member_path(*union_struct, "MyUnionStruct", root));
+    ASSERT_TRUE(root.steps.empty());
+    ASSERT_EQ(root.type, union_struct);
+
+    MemberPath path;
+    ASSERT_TRUE(Conversion::compile_member_path(*union_struct, "MyUnionStruct.my_union.my_string", path));
+    ASSERT_EQ(path.steps.size(), 2u);
+    ASSERT_EQ(path.type->kind(), xtypes::TypeKind::STRING_TYPE);
+
+    ASSERT_FALSE(Conversion::compile_member_path(*union_struct, "MyUnionStruct.my_union.unknown", path));
+    ASSERT_FALSE(Conversion::compile_member_path(*union_struct, "MyUnionStruct.my_union.my_string.size", path));
+
+    ASSERT_TRUE(Conversion::compile_member_path(*union_struct, "MyUnionStruct.my_union.my_string", path));
+
+    // The union case along the path is only selected when the member is accessed
+    xtypes::DynamicData xtypes_data(*union_struct);
+    fill_union_struct(xtypes_data, 0);
+    ASSERT_TRUE(Conversion::is_member_selected(xtypes_data, root));
+    ASSERT_FALSE(Conversion::is_member_selected(xtypes_data, path));
+
+    Conversion::access_member_data(xtypes_data, path) = "Union String";
+    ASSERT_TRUE(Conversion::is_member_selected(xtypes_data, path));
+    ASSERT_EQ(xtypes_data["my_union"]["my_string"].value<std::string>(), "Union String");
+}
+
+TEST(FastDDSUnitary, Get_metrics_of_the_system_handle)
+{
+    xtypes::idl::Context context = xtypes::idl::parse_file(fastdds_sh_unit_test_types);
+    ASSERT_TRUE(context.success);
+
+    auto result = context.get_all_scoped_types();
+    ASSERT_FALSE(result.empty());
+
+    const xtypes::DynamicType* basic_struct = result["BasicStruct"].get();
+    ASSERT_NE(basic_struct, nullptr);
+
+    SystemHandle system_handle;
+    core::RequiredTypes required_types;
+    TypeRegistry type_registry;
+    ASSERT_TRUE(system_handle.configure(
+                required_types, YAML::Load("participant: { domain_id: 42 }"), type_registry));
+    ASSERT_TRUE(system_handle.get_metrics().empty());
+
+    std::shared_ptr<TopicPublisher> publisher =
+            system_handle.advertise("metrics_topic", *basic_struct, YAML::Node());
+    ASSERT_NE(publisher, nullptr);
+
+    xtypes::DynamicData xtypes_data(*basic_struct);
+    fill_basic_struct(xtypes_data);
+    ASSERT_TRUE(publisher->publish(xtypes_data));
+
+    std::vector<TopicMetrics::Snapshot> metrics = system_handle.get_metrics();
+    ASSERT_EQ(metrics.size(), 1u);
+    ASSERT_EQ(metrics[0].entity, "publisher");
+    ASSERT_EQ(metrics[0].topic, "metrics_topic");
+    ASSERT_EQ(metrics[0].samples_in, 1u);
+}
+
 } //  namespace test
 } //  namespace fastdds
 } //  namespace sh